@@ -71,6 +71,30 @@
 				    (aoc2025/build-flag-label "Use undefined behavior sanitizer" "--ubsan"))
 		     :if (lambda () (not (eq system-type 'windows-nt))))
 
+		   (transient-define-argument aoc2025/toggle-trace ()
+		     "Toggle trace flag."
+		     :class 'transient-switch
+		     :key "-t"
+		     :argument "--trace"
+		     :description (lambda (_obj)
+				    (aoc2025/build-flag-label "Record a trace.json timeline" "--trace")))
+
+		   (transient-define-argument aoc2025/toggle-hot-reload ()
+		     "Toggle hot reload flag."
+		     :class 'transient-switch
+		     :key "-l"
+		     :argument "--hot-reload"
+		     :description (lambda (_obj)
+				    (aoc2025/build-flag-label "Build solvers as a hot reloadable library" "--hot-reload")))
+
+		   (transient-define-argument aoc2025/toggle-solvers-only ()
+		     "Toggle solvers only flag."
+		     :class 'transient-switch
+		     :key "-s"
+		     :argument "--solvers-only"
+		     :description (lambda (_obj)
+				    (aoc2025/build-flag-label "Only rebuild the solver library" "--solvers-only")))
+
 		   (transient-define-argument aoc2025/set-compiler ()
 		     "Set compiler."
 		     :class 'transient-option
@@ -169,6 +193,9 @@
 		      (aoc2025/specify-jobs)
 		      (aoc2025/toggle-asan)
 		      (aoc2025/toggle-ubsan)
+		      (aoc2025/toggle-trace)
+		      (aoc2025/toggle-hot-reload)
+		      (aoc2025/toggle-solvers-only)
 		      (aoc2025/set-compiler)
 		      (aoc2025/toggle-no-cache)
 		      (aoc2025/toggle-emit-compile-commands)
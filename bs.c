@@ -36,6 +36,8 @@
 #define CACHE_DIR      BUILD_DIR"/cache"
 
 #define AOC2025_OBJECT_DIR    OBJECT_DIR"/aoc2025"
+#define AOC2025_SOLVERS_OBJECT_DIR OBJECT_DIR"/aoc2025_solvers"
+#define AOC_SOLVE_OBJECT_DIR  OBJECT_DIR"/aoc_solve"
 
 #ifdef _MSC_VER
 #define AOC2025_BIN_NAME "aoc2025.exe"
@@ -45,6 +47,25 @@
 
 #define AOC2025_BIN           BIN_DIR"/"AOC2025_BIN_NAME
 
+#ifdef _MSC_VER
+#define AOC2025_SOLVERS_LIB_NAME "aoc2025_solvers.dll"
+#else
+#define AOC2025_SOLVERS_LIB_NAME "libaoc2025_solvers.so"
+#endif
+
+#define AOC2025_SOLVERS_LIB   BIN_DIR"/"AOC2025_SOLVERS_LIB_NAME
+
+#ifdef _MSC_VER
+#define AOC_SOLVERS_ARCHIVE_NAME "aoc_solvers.lib"
+#define AOC_SOLVE_BIN_NAME       "aoc_solve.exe"
+#else
+#define AOC_SOLVERS_ARCHIVE_NAME "libaoc_solvers.a"
+#define AOC_SOLVE_BIN_NAME       "aoc_solve"
+#endif
+
+#define AOC_SOLVERS_ARCHIVE   BIN_DIR"/"AOC_SOLVERS_ARCHIVE_NAME
+#define AOC_SOLVE_BIN         BIN_DIR"/"AOC_SOLVE_BIN_NAME
+
 #ifdef _MSC_VER
 #define AOC2025_DISTRIBUTION_DIR_NAME "aoc2025_windows_x64"
 #else
@@ -75,10 +96,10 @@ static const char *common_compile_options[] = {
     "/nologo", "/c", "/EHsc", "/utf-8"
 };
 static const char *debug_compile_options[] = {
-    "/Z7", "/Od", "/MTd",
+    "/Z7", "/Od",
 };
 static const char *release_compile_options[] = {
-    "/O2", "/GL", "/MT", "/Gy", "/Gw"
+    "/O2", "/GL", "/Gy", "/Gw"
 };
 static const char *aoc2025_compile_options[] = {
     "/W3"
@@ -90,7 +111,7 @@ static const char *release_definitions[] = {
     "/DNDEBUG", "/D_CRT_SECURE_NO_WARNINGS"
 };
 static const char *common_link_options[] = {
-    "/nologo", "/link", "/INCREMENTAL:NO", "user32.lib", "gdi32.lib", "shell32.lib", "Winmm.lib", "/SUBSYSTEM:WINDOWS", "/OPT:REF", "/OPT:ICF"
+    "/nologo", "/link", "/INCREMENTAL:NO", "user32.lib", "gdi32.lib", "shell32.lib", "Winmm.lib", "Synchronization.lib", "/SUBSYSTEM:WINDOWS", "/OPT:REF", "/OPT:ICF"
 };
 static const char *debug_link_options[] = {
     "/DEBUG"
@@ -148,6 +169,11 @@ static struct {
     bool emit_compile_commands;
     bool emit_vscode_tasks;
     bool asan;
+    bool trace;
+    bool track_allocations;
+    bool hot_reload;
+    bool solvers_only;
+    bool pgo;
 
     Compiler compiler;
 
@@ -266,6 +292,31 @@ init_cli(int argc, char **argv)
         ->description("Build and link with address sanitizer.")
         ->done();
 
+    cap_flag(cli.ctx, &cli.trace)
+        ->long_name("trace")
+        ->description("Record solver and frame timelines, written to trace.json on exit. Open it in Perfetto or chrome://tracing. Not with --hot-reload.")
+        ->done();
+
+    cap_flag(cli.ctx, &cli.track_allocations)
+        ->long_name("track-allocations")
+        ->description("Count the allocations of every solver run and report them with its timing. Makes the solvers slower.")
+        ->done();
+
+    cap_flag(cli.ctx, &cli.hot_reload)
+        ->long_name("hot-reload")
+        ->description("Build the day solvers into a separate shared library, which Aoc2025 reloads whenever it is rebuilt.")
+        ->done();
+
+    cap_flag(cli.ctx, &cli.solvers_only)
+        ->long_name("solvers-only")
+        ->description("Only rebuild the hot reloadable solver library. Implies --hot-reload.")
+        ->done();
+
+    cap_flag(cli.ctx, &cli.pgo)
+        ->long_name("pgo")
+        ->description("Build with profile guided optimization. Builds and benchmarks a plain binary, trains an instrumented one with `--bench` on real and generated inputs, rebuilds the solvers with the profile, and reports the speedup per day. gcc and clang only.")
+        ->done();
+
 #ifndef _MSC_VER
     cap_flag(cli.ctx, &cli.ubsan)
         ->long_name("ubsan")
@@ -289,6 +340,32 @@ init_cli(int argc, char **argv)
         NOB_NO_ECHO = false;
     }
 
+    if (cli.solvers_only) {
+        cli.hot_reload = true;
+    }
+
+    // The solver library would record into its own copy of the trace buffer,
+    // which nothing writes
+    if (cli.trace && cli.hot_reload) {
+        fprintf(stderr, "--trace can not be used with %s\n", cli.solvers_only ? "--solvers-only" : "--hot-reload");
+        cap_context_free(cli.ctx);
+        exit(1);
+    }
+
+    if (cli.pgo) {
+        const char *conflict = NULL;
+#ifdef _MSC_VER
+        conflict = "cl and clang-cl";
+#endif
+        if (cli.debug)      conflict = "--debug";
+        if (cli.hot_reload) conflict = "--hot-reload";
+        if (conflict) {
+            fprintf(stderr, "--pgo can not be used with %s\n", conflict);
+            cap_context_free(cli.ctx);
+            exit(1);
+        }
+    }
+
     switch (cli.compiler) {
 #ifdef _MSC_VER
     case COMPILER_CL: {
@@ -340,6 +417,7 @@ typedef struct {
     Strings  definitions;
     Strings  include_directories;
     Targets  targets;
+    bool     profile_guided; // Instrumented and optimized with --pgo
 } CompilationBlock;
 
 typedef struct {
@@ -354,6 +432,46 @@ typedef struct {
     size_t  count;
 } Cmds;
 
+// --pgo builds the app three times: plain for the baseline benchmark,
+// instrumented to record a profile, and optimized with that profile
+typedef enum {
+    PGO_OFF,
+    PGO_GENERATE,
+    PGO_USE,
+} PgoPhase;
+
+static PgoPhase pgo_phase = PGO_OFF;
+
+#define PGO_DIR             BUILD_DIR"/pgo"
+#define PGO_PROFDATA        PGO_DIR"/aoc2025.profdata"
+#define PGO_BASELINE_BENCH  PGO_DIR"/baseline.txt"
+#define PGO_OPTIMIZED_BENCH PGO_DIR"/optimized.txt"
+#define PGO_TRAINING_BENCH_FORMAT PGO_DIR"/training_%s.txt"
+#define PGO_TRAINING_RUNS   "3"
+#define PGO_BENCH_RUNS      "20"
+
+static inline void
+add_pgo_options(Cmd *cmd)
+{
+#ifndef _MSC_VER
+    switch (pgo_phase) {
+    case PGO_OFF: break;
+    case PGO_GENERATE: {
+        cmd_append(cmd, "-fprofile-generate="PGO_DIR);
+    } break;
+    case PGO_USE: {
+        if (cli.compiler == COMPILER_CLANG) {
+            cmd_append(cmd, "-fprofile-use="PGO_PROFDATA, "-Wno-profile-instr-unprofiled", "-Wno-profile-instr-out-of-date");
+        } else {
+            cmd_append(cmd, "-fprofile-use="PGO_DIR, "-fprofile-partial-training", "-Wno-missing-profile");
+        }
+    } break;
+    }
+#else
+    UNUSED(cmd);
+#endif
+}
+
 static inline void
 add_sanitizer_option(Cmd *cmd)
 {
@@ -377,7 +495,9 @@ generate_compile_commands(CompilationBlocks *blocks)
         da_foreach(Target, target, &block->targets) {
             Cmd cmd = {0};
 
-            if (cli.cache) {
+            // ccache can not tell when the profile an object was built with changes
+            bool profiled = block->profile_guided && pgo_phase != PGO_OFF;
+            if (cli.cache && !profiled) {
                 da_append(&cmd, CCACHE_BIN);
             }
 
@@ -404,7 +524,15 @@ generate_compile_commands(CompilationBlocks *blocks)
             if (cli.compiler == COMPILER_CLANG_CL) da_append(&cmd, "-Wno-unused-command-line-argument");
 #endif
 
+#ifdef _MSC_VER
+            // The hot reloaded solver library hands malloc'd answers over to
+            // the app, so both must share the DLL runtime and its heap
+            if (cli.hot_reload) da_append(&cmd, cli.debug ? "/MDd" : "/MD");
+            else                da_append(&cmd, cli.debug ? "/MTd" : "/MT");
+#endif
+
             add_sanitizer_option(&cmd);
+            if (profiled) add_pgo_options(&cmd);
 
             da_foreach(const char *, option, &block->options) {
                 da_append(&cmd, *option);
@@ -769,6 +897,14 @@ prepare_stb_ds(CompilationBlocks *blocks)
     da_append(&block.definitions, "PLATFORM_DESKTOP_GLFW");
     da_append(&block.include_directories, GLFW_INCLUDE_DIR);
 
+    // The solvers grow their arrays in here
+    if (cli.track_allocations) {
+        da_append(&block.definitions, "AOC2025_ALLOC_TRACK");
+        da_append(&block.include_directories, SRC_DIR);
+    }
+
+    block.profile_guided = true;
+
     ThirdPartyLicense license = {"stb_ds", STB_DS_DIR"/LICENSE"};
     da_append(&third_party_licenses, license);
 
@@ -796,6 +932,7 @@ prepare_sv(CompilationBlocks *blocks)
         da_append(&block.targets, sv_targets[i]);
     }
 
+    block.profile_guided = true;
 
     ThirdPartyLicense license = {"sv", SV_DIR"/LICENSE"};
     da_append(&third_party_licenses, license);
@@ -816,18 +953,12 @@ prepare_aoc2025(CompilationBlocks *blocks)
     Target targets[] = {
         { .source = SRC_DIR"/aoc2025.c",
           .object = AOC2025_OBJECT_DIR"/aoc2025"OBJ_FILE_EXT},
-        { .source = SRC_DIR"/basic.c",
-          .object = AOC2025_OBJECT_DIR"/basic"OBJ_FILE_EXT},
-        { .source = SRC_DIR"/day1.c",
-          .object = AOC2025_OBJECT_DIR"/day1"OBJ_FILE_EXT},
-        { .source = SRC_DIR"/day2.c",
-          .object = AOC2025_OBJECT_DIR"/day2"OBJ_FILE_EXT},
-        { .source = SRC_DIR"/day3.c",
-          .object = AOC2025_OBJECT_DIR"/day3"OBJ_FILE_EXT},
-        { .source = SRC_DIR"/day4.c",
-          .object = AOC2025_OBJECT_DIR"/day4"OBJ_FILE_EXT},
-        { .source = SRC_DIR"/day5.c",
-          .object = AOC2025_OBJECT_DIR"/day5"OBJ_FILE_EXT},
+        { .source = SRC_DIR"/runner.c",
+          .object = AOC2025_OBJECT_DIR"/runner"OBJ_FILE_EXT},
+        { .source = AOC2025_GENERATED_DIR"/embedded_data.c",
+          .object = AOC2025_OBJECT_DIR"/embedded_data"OBJ_FILE_EXT},
+        { .source = AOC2025_GENERATED_DIR"/embedded_fonts.c",
+          .object = AOC2025_OBJECT_DIR"/embedded_fonts"OBJ_FILE_EXT},
 #ifdef _MSC_VER
         { .source = SRC_DIR"/win32_aoc2025.c",
           .object = AOC2025_OBJECT_DIR"/win32_aoc2025"OBJ_FILE_EXT},
@@ -840,17 +971,206 @@ prepare_aoc2025(CompilationBlocks *blocks)
         da_append(&block.targets, targets[i]);
     }
 
+    // Otherwise these come with the solver archive
+    if (cli.hot_reload) {
+        Target library_targets[] = {
+            { .source = SRC_DIR"/basic.c",
+              .object = AOC2025_OBJECT_DIR"/basic"OBJ_FILE_EXT},
+            { .source = SRC_DIR"/trace.c",
+              .object = AOC2025_OBJECT_DIR"/trace"OBJ_FILE_EXT},
+            { .source = SRC_DIR"/grid_frames.c",
+              .object = AOC2025_OBJECT_DIR"/grid_frames"OBJ_FILE_EXT},
+        };
+        for (size_t i = 0; i < ARRAY_LENGTH(library_targets); ++i) {
+            da_append(&block.targets, library_targets[i]);
+        }
+    }
+
     for (size_t i = 0; i < ARRAY_LENGTH(aoc2025_compile_options); ++i) {
         da_append(&block.options, aoc2025_compile_options[i]);
     }
 
+    if (cli.trace) {
+        da_append(&block.definitions, "AOC2025_TRACE");
+    }
+    if (cli.track_allocations) {
+        da_append(&block.definitions, "AOC2025_ALLOC_TRACK");
+    }
+    if (cli.hot_reload) {
+        da_append(&block.definitions, "AOC2025_HOT_RELOAD");
+    }
+
     da_append(&block.include_directories, "vendor/cap/");
 
     da_append(&block.include_directories, RAYLIB_SRC_DIR);
+    da_append(&block.include_directories, GLFW_INCLUDE_DIR);
     da_append(&block.include_directories, CLAY_DIR);
     da_append(&block.include_directories, STB_DS_DIR);
     da_append(&block.include_directories, SV_DIR);
     da_append(&block.include_directories, AOC2025_GENERATED_DIR);
+    da_append(&block.include_directories, SRC_DIR); // For the generated sources
+
+#ifdef _MSC_VER
+    da_append(&block.options, "/wd4244");
+    da_append(&block.options, "/wd4305");
+#endif
+
+    da_append(blocks, block);
+
+    return true;
+}
+
+// The day sources are built once per x86-64 instruction set level, and the
+// app picks one for the cpu it runs on, see src/days.h. The suffixes must
+// match the ones in src/days.c.
+static const struct {
+    const char *suffix;
+    const char *option;
+    const char *name; // As `aoc2025 --isa` takes it
+} solver_isas[] = {
+#ifdef _MSC_VER
+    { "_baseline", NULL,           "baseline" },
+    { "_sse42",    "/arch:SSE4.2", "sse4.2"   },
+    { "_avx2",     "/arch:AVX2",   "avx2"     },
+    { "_avx512",   "/arch:AVX512", "avx512"   },
+#else
+    { "_baseline", NULL,               "baseline" },
+    { "_sse42",    "-march=x86-64-v2", "sse4.2"   },
+    { "_avx2",     "-march=x86-64-v3", "avx2"     },
+    { "_avx512",   "-march=x86-64-v4", "avx512"   },
+#endif
+};
+
+// Levels the --pgo training ran, the only ones built with its profile. The
+// build machine's cpu may not run the highest ones, and a level without
+// counts would be optimized as if all of it were cold.
+static bool solver_isa_trained[ARRAY_LENGTH(solver_isas)];
+
+static const char *day_sources[] = { "day1", "day2", "day3", "day4", "day5" };
+
+static inline void
+add_aoc2025_solver_options(CompilationBlock *block)
+{
+    for (size_t i = 0; i < ARRAY_LENGTH(aoc2025_compile_options); ++i) {
+        da_append(&block->options, aoc2025_compile_options[i]);
+    }
+
+    if (cli.trace) {
+        da_append(&block->definitions, "AOC2025_TRACE");
+    }
+    if (cli.track_allocations) {
+        da_append(&block->definitions, "AOC2025_ALLOC_TRACK");
+    }
+    if (cli.hot_reload) {
+        da_append(&block->definitions, "AOC2025_SOLVERS_SHARED");
+    }
+
+    da_append(&block->include_directories, STB_DS_DIR);
+    da_append(&block->include_directories, SV_DIR);
+    da_append(&block->include_directories, AOC2025_GENERATED_DIR);
+
+#ifdef _MSC_VER
+    da_append(&block->options, "/wd4244");
+    da_append(&block->options, "/wd4305");
+#endif
+
+    block->profile_guided = true;
+}
+
+// The day solvers, with basic.c, trace.c, grid_frames.c and alloc_track.c, go
+// into a static library without any GUI dependencies. The app and aoc_solve
+// link it, or with --hot-reload the same objects make up a shared library the
+// app loads, and the app gets private copies of the first three.
+static inline bool
+prepare_aoc2025_solvers(CompilationBlocks *blocks)
+{
+    if (!mkdir_if_not_exists(AOC2025_SOLVERS_OBJECT_DIR)) return false;
+
+    CompilationBlock block = {0};
+
+    Target targets[] = {
+        { .source = SRC_DIR"/days.c",
+          .object = AOC2025_SOLVERS_OBJECT_DIR"/days"OBJ_FILE_EXT},
+        { .source = SRC_DIR"/parsed_input.c",
+          .object = AOC2025_SOLVERS_OBJECT_DIR"/parsed_input"OBJ_FILE_EXT},
+        { .source = SRC_DIR"/parallel_lines.c",
+          .object = AOC2025_SOLVERS_OBJECT_DIR"/parallel_lines"OBJ_FILE_EXT},
+        { .source = SRC_DIR"/containers.c",
+          .object = AOC2025_SOLVERS_OBJECT_DIR"/containers"OBJ_FILE_EXT},
+        { .source = SRC_DIR"/basic.c",
+          .object = AOC2025_SOLVERS_OBJECT_DIR"/basic"OBJ_FILE_EXT},
+        { .source = SRC_DIR"/trace.c",
+          .object = AOC2025_SOLVERS_OBJECT_DIR"/trace"OBJ_FILE_EXT},
+        { .source = SRC_DIR"/grid_frames.c",
+          .object = AOC2025_SOLVERS_OBJECT_DIR"/grid_frames"OBJ_FILE_EXT},
+        { .source = SRC_DIR"/alloc_track.c",
+          .object = AOC2025_SOLVERS_OBJECT_DIR"/alloc_track"OBJ_FILE_EXT},
+    };
+    for (size_t i = 0; i < ARRAY_LENGTH(targets); ++i) {
+        da_append(&block.targets, targets[i]);
+    }
+
+    add_aoc2025_solver_options(&block);
+    da_append(blocks, block);
+
+    for (size_t i = 0; i < ARRAY_LENGTH(solver_isas); ++i) {
+        CompilationBlock isa_block = {0};
+
+        for (size_t j = 0; j < ARRAY_LENGTH(day_sources); ++j) {
+            Target isa_target = {
+                .source = temp_sprintf(SRC_DIR"/%s.c", day_sources[j]),
+                .object = temp_sprintf(AOC2025_SOLVERS_OBJECT_DIR"/%s%s"OBJ_FILE_EXT, day_sources[j], solver_isas[i].suffix)
+            };
+            da_append(&isa_block.targets, isa_target);
+        }
+
+        add_aoc2025_solver_options(&isa_block);
+        if (pgo_phase == PGO_USE && !solver_isa_trained[i]) isa_block.profile_guided = false;
+        da_append(&isa_block.definitions, temp_sprintf("SOLVER_ISA_SUFFIX=%s", solver_isas[i].suffix));
+        if (solver_isas[i].option) da_append(&isa_block.options, solver_isas[i].option);
+
+        da_append(blocks, isa_block);
+    }
+
+    return true;
+}
+
+// Headless front end to the solver archive
+static inline bool
+prepare_aoc_solve(CompilationBlocks *blocks)
+{
+    if (!mkdir_if_not_exists(AOC_SOLVE_OBJECT_DIR)) return false;
+
+    CompilationBlock block = {0};
+
+    Target targets[] = {
+        { .source = SRC_DIR"/aoc_solve.c",
+          .object = AOC_SOLVE_OBJECT_DIR"/aoc_solve"OBJ_FILE_EXT},
+        { .source = SRC_DIR"/runner.c",
+          .object = AOC_SOLVE_OBJECT_DIR"/runner"OBJ_FILE_EXT},
+        { .source = SRC_DIR"/containers_bench.c",
+          .object = AOC_SOLVE_OBJECT_DIR"/containers_bench"OBJ_FILE_EXT},
+        { .source = SRC_DIR"/input_loader.c",
+          .object = AOC_SOLVE_OBJECT_DIR"/input_loader"OBJ_FILE_EXT},
+    };
+    for (size_t i = 0; i < ARRAY_LENGTH(targets); ++i) {
+        da_append(&block.targets, targets[i]);
+    }
+
+    for (size_t i = 0; i < ARRAY_LENGTH(aoc2025_compile_options); ++i) {
+        da_append(&block.options, aoc2025_compile_options[i]);
+    }
+
+    if (cli.trace) {
+        da_append(&block.definitions, "AOC2025_TRACE");
+    }
+    if (cli.track_allocations) {
+        da_append(&block.definitions, "AOC2025_ALLOC_TRACK");
+    }
+
+    da_append(&block.include_directories, "vendor/cap/");
+    da_append(&block.include_directories, STB_DS_DIR);
+    da_append(&block.include_directories, AOC2025_GENERATED_DIR);
 
 #ifdef _MSC_VER
     da_append(&block.options, "/wd4244");
@@ -922,6 +1242,334 @@ done:
     return return_val;
 }
 
+static inline uint64_t
+fnv1a_hash(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static inline bool
+is_solver_source(const char *file_name)
+{
+    String_View name = sv_from_cstr(file_name);
+    if (sv_starts_with(name, sv_from_cstr("day"))) return true;
+    if (strcmp(file_name, "basic.c") == 0 || strcmp(file_name, "basic.h") == 0) return true;
+    if (strcmp(file_name, "parsed_input.c") == 0 || strcmp(file_name, "parsed_input.h") == 0) return true;
+    if (strcmp(file_name, "parallel_lines.c") == 0 || strcmp(file_name, "parallel_lines.h") == 0) return true;
+    if (strcmp(file_name, "containers.c") == 0 || strcmp(file_name, "containers.h") == 0) return true;
+    return false;
+}
+
+// The app keys its persistent result cache on this id, so it must change
+// whenever a rebuilt solver could produce different answers: solver sources,
+// the libraries they use, and the flags they are built with.
+static inline bool
+generate_solver_build_id(void)
+{
+    bool return_val = true;
+
+    File_Paths     files = {0};
+    String_Builder sb    = {0};
+    size_t chk = temp_save();
+
+    uint64_t id = 0;
+
+    DO_OR_FAIL(read_entire_dir(SRC_DIR, &files));
+    static const char *library_sources[] = {
+        SV_DIR"/sv.c", SV_DIR"/sv.h", STB_DS_DIR"/stb_ds.h"
+    };
+    for (size_t i = 0; i < ARRAY_LENGTH(library_sources); ++i) {
+        da_append(&files, library_sources[i]);
+    }
+
+    da_foreach(const char *, file, &files) {
+        const char *path = *file;
+        if (strchr(path, '/') == NULL) {
+            if (!is_solver_source(path)) continue;
+            path = temp_sprintf(SRC_DIR"/%s", path);
+        }
+
+        sb.count = 0;
+        DO_OR_FAIL(read_entire_file(path, &sb));
+        uint64_t file_hash = fnv1a_hash(14695981039346656037ull, path, strlen(path));
+        file_hash = fnv1a_hash(file_hash, sb.items, sb.count);
+        id += file_hash; // Order independent, directory listings are not sorted
+    }
+
+    const char *flags = temp_sprintf("%s debug=%d asan=%d", CC, cli.debug, cli.asan);
+    id = fnv1a_hash(id, flags, strlen(flags));
+
+    const char *content = temp_sprintf("#define AOC2025_SOLVER_BUILD_ID 0x%016llxull\n", (unsigned long long)id);
+    const char *header  = AOC2025_GENERATED_DIR"/solver_build_id.h";
+
+    // Only touch the header when the id changes
+    sb.count = 0;
+    if (!file_exists(header) || !read_entire_file(header, &sb) || sb.count != strlen(content) || memcmp(sb.items, content, sb.count) != 0) {
+        DO_OR_FAIL(write_entire_file(header, content, strlen(content)));
+    }
+
+done:
+    temp_rewind(chk);
+    da_free(files);
+    sb_free(sb);
+    return return_val;
+}
+
+// Writes path only when its content differs, so an unchanged generated
+// source is not rebuilt
+static inline bool
+write_file_if_changed(const char *path, const char *content, size_t size)
+{
+    String_Builder sb = {0};
+    bool changed = !file_exists(path) || !read_entire_file(path, &sb) || sb.count != size || memcmp(sb.items, content, size) != 0;
+    sb_free(sb);
+    if (!changed) return true;
+    return write_entire_file(path, content, size);
+}
+
+static int
+compare_paths(const void *a, const void *b)
+{
+    return strcmp(*(const char **)a, *(const char **)b);
+}
+
+// Fonts are baked into atlases instead, and the Windows icon goes into the resource file
+static inline bool
+is_embedded_data_file(const char *path)
+{
+    String_View name = sv_from_cstr(path);
+    return !sv_end_with(name, ".ttf") && !sv_end_with(name, ".ico");
+}
+
+static inline bool
+collect_data_files(const char *dir, File_Paths *out)
+{
+    bool return_val = true;
+
+    File_Paths children = {0};
+    DO_OR_FAIL(read_entire_dir(dir, &children));
+    da_foreach(const char *, child, &children) {
+        if (strcmp(*child, ".") == 0 || strcmp(*child, "..") == 0) continue;
+        const char *path = temp_sprintf("%s/%s", dir, *child);
+        File_Type   type = get_file_type(path);
+        if (type == FILE_DIRECTORY) {
+            DO_OR_FAIL(collect_data_files(path, out));
+        } else if (type == FILE_REGULAR && is_embedded_data_file(path)) {
+            da_append(out, path);
+        }
+    }
+
+done:
+    da_free(children);
+    return return_val;
+}
+
+// Everything under data/ the app needs goes into embedded_data.c as one zero
+// terminated byte array per file, looked up by path through embedded_file()
+// from src/embedded.h.
+static inline bool
+generate_embedded_data(void)
+{
+    bool return_val = true;
+
+    File_Paths     files = {0};
+    String_Builder file  = {0};
+    String_Builder out   = {0};
+    size_t chk = temp_save();
+
+    DO_OR_FAIL(collect_data_files(DATA_DIR, &files));
+    // Directory listings are not sorted, the output should not change with them
+    qsort(files.items, files.count, sizeof(*files.items), compare_paths);
+
+    sb_append_cstr(&out, "// Generated by bs, do not edit\n");
+    sb_append_cstr(&out, "#include \"embedded.h\"\n\n");
+    sb_append_cstr(&out, "#include <string.h>\n");
+
+    for (size_t i = 0; i < files.count; ++i) {
+        file.count = 0;
+        DO_OR_FAIL(read_entire_file(files.items[i], &file));
+        sb_appendf(&out, "\n// %s\n", files.items[i]);
+        sb_appendf(&out, "EMBEDDED_ALIGNED static const unsigned char file%zu[%zu] = {", i, file.count + 1);
+        for (size_t j = 0; j < file.count; ++j) {
+            sb_appendf(&out, j % 32 == 0 ? "\n    %u," : "%u,", (unsigned)(unsigned char)file.items[j]);
+        }
+        sb_append_cstr(&out, "\n    0\n};\n");
+    }
+
+    sb_append_cstr(&out, "\nstatic const EmbeddedFile embedded_files[] = {\n");
+    for (size_t i = 0; i < files.count; ++i) {
+        file.count = 0;
+        DO_OR_FAIL(read_entire_file(files.items[i], &file));
+        sb_appendf(&out, "    {\"%s\", file%zu, %zu},\n", files.items[i], i, file.count);
+    }
+    sb_append_cstr(&out, "    {0}\n};\n");
+    sb_append_cstr(&out,
+        "\n"
+        "const EmbeddedFile *\n"
+        "embedded_file(const char *path)\n"
+        "{\n"
+        "    for (const EmbeddedFile *file = embedded_files; file->path; ++file) {\n"
+        "        if (strcmp(file->path, path) == 0) return file;\n"
+        "    }\n"
+        "    return NULL;\n"
+        "}\n");
+
+    DO_OR_FAIL(write_file_if_changed(AOC2025_GENERATED_DIR"/embedded_data.c", out.items, out.count));
+
+done:
+    temp_rewind(chk);
+    da_free(files);
+    sb_free(file);
+    sb_free(out);
+    return return_val;
+}
+
+#define BAKE_FONTS_SOURCE "tools/bake_fonts.c"
+#define TOOLS_BIN_DIR     BUILD_DIR"/tools"
+#ifdef _MSC_VER
+#define BAKE_FONTS_BIN TOOLS_BIN_DIR"/bake_fonts.exe"
+#else
+#define BAKE_FONTS_BIN TOOLS_BIN_DIR"/bake_fonts"
+#endif
+
+// Must match the fonts the app asks for at startup
+static const struct {
+    const char *path;
+    const char *size;
+} baked_fonts[] = {
+    { DATA_DIR"/Roboto-Regular.ttf",    "48" },
+    { DATA_DIR"/Roboto-Regular.ttf",    "32" },
+    { DATA_DIR"/RobotoMono-Medium.ttf", "32" },
+};
+
+// The atlases go into embedded_fonts.c. Rasterizing needs stb_truetype and
+// with it the math library, which bs is bootstrapped without, so it is done
+// by a small tool bs builds first.
+static inline bool
+generate_embedded_fonts(void)
+{
+    bool return_val = true;
+
+    Cmd cmd = {0};
+
+    DO_OR_FAIL(mkdir_if_not_exists(TOOLS_BIN_DIR));
+    if (needs_rebuild1(BAKE_FONTS_BIN, BAKE_FONTS_SOURCE)) {
+        cmd_append(&cmd, CC);
+#ifdef _MSC_VER
+        cmd_append(&cmd, "/nologo", "/O2", "/D_CRT_SECURE_NO_WARNINGS", "/I"RAYLIB_SRC_DIR"/external");
+        cmd_append(&cmd, "/Fe:"BAKE_FONTS_BIN, "/Fo:"TOOLS_BIN_DIR"/bake_fonts.obj", BAKE_FONTS_SOURCE);
+#else
+        cmd_append(&cmd, "-O2", "-I"RAYLIB_SRC_DIR"/external", "-o", BAKE_FONTS_BIN, BAKE_FONTS_SOURCE, "-lm");
+#endif
+        DO_OR_FAIL(cmd_run_sync_and_reset(&cmd));
+    }
+
+    cmd_append(&cmd, BAKE_FONTS_BIN, AOC2025_GENERATED_DIR"/embedded_fonts.c");
+    for (size_t i = 0; i < ARRAY_LENGTH(baked_fonts); ++i) {
+        cmd_append(&cmd, baked_fonts[i].path, baked_fonts[i].size);
+    }
+    DO_OR_FAIL(cmd_run_sync_and_reset(&cmd));
+
+done:
+    da_free(cmd);
+    return return_val;
+}
+
+// Replaces the archive instead of updating it, so objects that are not built
+// anymore do not linger in it
+static inline bool
+archive_aoc_solvers(CompilationBlocks *solver_blocks)
+{
+    bool return_val = true;
+
+    printf("\nArchiving \""AOC_SOLVERS_ARCHIVE"\"...\n"); fflush(stdout);
+
+    Cmd cmd = {0};
+
+    if (file_exists(AOC_SOLVERS_ARCHIVE)) DO_OR_FAIL(delete_file(AOC_SOLVERS_ARCHIVE));
+
+#ifdef _MSC_VER
+    da_append(&cmd, cli.compiler == COMPILER_CLANG_CL ? "llvm-lib" : "lib");
+    cmd_append(&cmd, "/nologo", "/OUT:"AOC_SOLVERS_ARCHIVE);
+    if (!cli.debug) da_append(&cmd, "/LTCG");
+#else
+    // The wrappers add the link time optimization symbol table
+    da_append(&cmd, cli.compiler == COMPILER_CLANG ? "llvm-ar" : "gcc-ar");
+    cmd_append(&cmd, "rcs", AOC_SOLVERS_ARCHIVE);
+#endif
+
+    da_foreach(CompilationBlock, block, solver_blocks) {
+        da_foreach(Target, target, &block->targets) {
+            da_append(&cmd, target->object);
+        }
+    }
+
+    DO_OR_FAIL(cmd_run(&cmd));
+done:
+    da_free(cmd);
+
+    return return_val;
+}
+
+static inline bool
+link_aoc_solve(CompilationBlocks *headless_blocks)
+{
+    bool return_val = true;
+
+    printf("\nLinking \""AOC_SOLVE_BIN"\"...\n"); fflush(stdout);
+
+    Cmd cmd = {0};
+
+    da_append(&cmd, CC);
+
+#ifdef _MSC_VER
+    da_append(&cmd, temp_sprintf("/Fe:%s", AOC_SOLVE_BIN));
+#else
+    da_append(&cmd, "-o");
+    da_append(&cmd, AOC_SOLVE_BIN);
+#endif
+
+    da_foreach(CompilationBlock, block, headless_blocks) {
+        da_foreach(Target, target, &block->targets) {
+            da_append(&cmd, target->object);
+        }
+    }
+    da_append(&cmd, AOC_SOLVERS_ARCHIVE);
+
+#ifdef _MSC_VER
+    cmd_append(&cmd, "/nologo", "/link", "/INCREMENTAL:NO", "Synchronization.lib", "/SUBSYSTEM:CONSOLE", "/OPT:REF", "/OPT:ICF");
+#else
+    for (size_t i = 0; i < ARRAY_LENGTH(common_link_options); ++i) {
+        da_append(&cmd, common_link_options[i]);
+    }
+#endif
+    if (cli.debug) {
+        for (size_t i = 0; i < ARRAY_LENGTH(debug_link_options); ++i) {
+            da_append(&cmd, debug_link_options[i]);
+        }
+    } else {
+        for (size_t i = 0; i < ARRAY_LENGTH(release_link_options); ++i) {
+            da_append(&cmd, release_link_options[i]);
+        }
+    }
+
+#ifndef _MSC_VER
+    add_sanitizer_option(&cmd);
+    add_pgo_options(&cmd);
+#endif
+
+    DO_OR_FAIL(cmd_run(&cmd));
+done:
+    da_free(cmd);
+
+    return return_val;
+}
+
 static inline bool
 link_aoc2025(CompilationBlocks *blocks)
 {
@@ -946,6 +1594,8 @@ link_aoc2025(CompilationBlocks *blocks)
         }
     }
 
+    if (!cli.hot_reload) da_append(&cmd, AOC_SOLVERS_ARCHIVE);
+
 #ifdef _MSC_VER
     da_append(&cmd, AOC2025_GENERATED_DIR"/win32_resource.res");
 #endif
@@ -967,9 +1617,70 @@ link_aoc2025(CompilationBlocks *blocks)
     // gcc/clang wants sanitizers to be specified both during object building and linking,
     // while cl is happy just being informed during object building.
     add_sanitizer_option(&cmd);
+    // Same for the profile, which also has to reach link time optimization
+    add_pgo_options(&cmd);
+#endif
+
+    DO_OR_FAIL(cmd_run(&cmd));
+done:
+    da_free(cmd);
+
+    return return_val;
+}
+
+// Links to a temporary file first and renames it into place, so a running
+// Aoc2025 never sees a half-written library
+static inline bool
+link_aoc2025_solvers(CompilationBlocks *blocks)
+{
+    bool return_val = true;
+
+    printf("\nLinking \""AOC2025_SOLVERS_LIB"\"...\n"); fflush(stdout);
+
+    Cmd cmd = {0};
+
+    const char *temporary_path = AOC2025_SOLVERS_LIB".tmp";
+
+    da_append(&cmd, CXX);
+
+#ifdef _MSC_VER
+    da_append(&cmd, "/LD");
+    da_append(&cmd, temp_sprintf("/Fe:%s", temporary_path));
+#else
+    da_append(&cmd, "-shared");
+    da_append(&cmd, "-o");
+    da_append(&cmd, temporary_path);
+#endif
+
+    da_foreach(CompilationBlock, block, blocks) {
+        da_foreach(Target, target, &block->targets) {
+            da_append(&cmd, target->object);
+        }
+    }
+
+#ifdef _MSC_VER
+    cmd_append(&cmd, "/nologo", "/link", "/DLL", "/INCREMENTAL:NO", "Synchronization.lib", "/OPT:REF", "/OPT:ICF");
+#else
+    for (size_t i = 0; i < ARRAY_LENGTH(common_link_options); ++i) {
+        da_append(&cmd, common_link_options[i]);
+    }
+#endif
+    if (cli.debug) {
+        for (size_t i = 0; i < ARRAY_LENGTH(debug_link_options); ++i) {
+            da_append(&cmd, debug_link_options[i]);
+        }
+    } else {
+        for (size_t i = 0; i < ARRAY_LENGTH(release_link_options); ++i) {
+            da_append(&cmd, release_link_options[i]);
+        }
+    }
+
+#ifndef _MSC_VER
+    add_sanitizer_option(&cmd);
 #endif
 
     DO_OR_FAIL(cmd_run(&cmd));
+    DO_OR_FAIL(nob_rename(temporary_path, AOC2025_SOLVERS_LIB));
 done:
     da_free(cmd);
 
@@ -1151,26 +1862,52 @@ done:
 }
 
 static inline bool
-generate_stuff(CompilationBlocks *blocks, Cmds *out_compile_commands)
+generate_stuff(CompilationBlocks *blocks, CompilationBlocks *solver_blocks, CompilationBlocks *headless_blocks,
+               Cmds *out_compile_commands)
 {
     bool return_val = true;
 
+    // --pgo generates more than once
+    third_party_licenses.count = 0;
+
     DO_OR_FAIL(mkdir_if_not_exists(BUILD_DIR));
     DO_OR_FAIL(mkdir_if_not_exists(OBJECT_DIR));
     DO_OR_FAIL(mkdir_if_not_exists(GENERATED_DIR));
     DO_OR_FAIL(mkdir_if_not_exists(AOC2025_GENERATED_DIR));
 
     DO_OR_FAIL(generate_win32_resource_file());
+    DO_OR_FAIL(generate_solver_build_id());
     DO_OR_FAIL(generate_wayland_files());
+    if (!cli.solvers_only) {
+        DO_OR_FAIL(generate_embedded_data());
+        DO_OR_FAIL(generate_embedded_fonts());
+    }
 
-    DO_OR_FAIL(prepare_aoc2025(blocks));
-    DO_OR_FAIL(prepare_raylib(blocks));
-    DO_OR_FAIL(prepare_glfw(blocks));
-    DO_OR_FAIL(prepare_stb_ds(blocks));
-    DO_OR_FAIL(prepare_sv(blocks));
-    DO_OR_FAIL(prepare_clay(blocks));
+    if (!cli.solvers_only) {
+        DO_OR_FAIL(prepare_aoc2025(blocks));
+        DO_OR_FAIL(prepare_raylib(blocks));
+        DO_OR_FAIL(prepare_glfw(blocks));
+        DO_OR_FAIL(prepare_clay(blocks));
+        DO_OR_FAIL(prepare_aoc_solve(headless_blocks));
+    }
+
+    DO_OR_FAIL(prepare_aoc2025_solvers(solver_blocks));
+    DO_OR_FAIL(prepare_stb_ds(solver_blocks));
+    DO_OR_FAIL(prepare_sv(solver_blocks));
+#ifndef _MSC_VER
+    // Real code next to gcc's LTO bytecode, so programs built without -flto can link the archive too
+    if (!cli.debug && cli.compiler == COMPILER_GCC) {
+        da_foreach(CompilationBlock, block, solver_blocks) da_append(&block->options, "-ffat-lto-objects");
+    }
+#endif
 
     *out_compile_commands = generate_compile_commands(blocks);
+    CompilationBlocks *other_blocks[] = { solver_blocks, headless_blocks };
+    for (size_t i = 0; i < ARRAY_LENGTH(other_blocks); ++i) {
+        Cmds other_compile_commands = generate_compile_commands(other_blocks[i]);
+        da_append_many(out_compile_commands, other_compile_commands.items, other_compile_commands.count);
+        da_free(other_compile_commands);
+    }
 
     if (cli.emit_compile_commands) {
         DO_OR_FAIL(generate_compilation_database(out_compile_commands));
@@ -1222,10 +1959,13 @@ package_distribution(void)
     // Make and copy everything into distribution directory
     if (file_exists(AOC2025_DISTRIBUTION_DIR)) DO_OR_FAIL(nob_delete_tree(AOC2025_DISTRIBUTION_DIR));
     DO_OR_FAIL(mkdir_if_not_exists(AOC2025_DISTRIBUTION_DIR));
-    DO_OR_FAIL(copy_directory_recursively(DATA_DIR, AOC2025_DISTRIBUTION_DIR"/data"));
     DO_OR_FAIL(copy_file(AOC2025_BIN, AOC2025_DISTRIBUTION_DIR"/"AOC2025_BIN_NAME));
+    DO_OR_FAIL(copy_file(AOC_SOLVE_BIN, AOC2025_DISTRIBUTION_DIR"/"AOC_SOLVE_BIN_NAME));
+    if (cli.hot_reload) {
+        DO_OR_FAIL(copy_file(AOC2025_SOLVERS_LIB, AOC2025_DISTRIBUTION_DIR"/"AOC2025_SOLVERS_LIB_NAME));
+    }
 #ifndef _MSC_VER
-    cmd_append(&cmd, "strip", "-s", AOC2025_DISTRIBUTION_DIR"/"AOC2025_BIN_NAME);
+    cmd_append(&cmd, "strip", "-s", AOC2025_DISTRIBUTION_DIR"/"AOC2025_BIN_NAME, AOC2025_DISTRIBUTION_DIR"/"AOC_SOLVE_BIN_NAME);
     DO_OR_FAIL(cmd_run_sync_and_reset(&cmd));
 #endif
 
@@ -1269,6 +2009,215 @@ done:
     return return_val;
 }
 
+// A full build of the app, for the --pgo runs before the final build
+static inline bool
+build_aoc2025_for_profiling(void)
+{
+    bool return_val = true;
+
+    CompilationBlocks blocks = {0};
+    CompilationBlocks solver_blocks = {0};
+    CompilationBlocks headless_blocks = {0};
+    Cmds compile_commands = {0};
+
+    DO_OR_FAIL(generate_stuff(&blocks, &solver_blocks, &headless_blocks, &compile_commands));
+    DO_OR_FAIL(mkdir_if_not_exists(BIN_DIR));
+    DO_OR_FAIL(build_objects(&compile_commands));
+    DO_OR_FAIL(archive_aoc_solvers(&solver_blocks));
+    DO_OR_FAIL(link_aoc2025(&blocks));
+
+done:
+    da_foreach(Cmd, compile_command, &compile_commands) da_free(*compile_command);
+    da_free(compile_commands);
+    da_free(blocks);
+    da_free(solver_blocks);
+    da_free(headless_blocks);
+    return return_val;
+}
+
+// isa is a level name for `aoc2025 --isa`, NULL for the one the cpu picks
+static inline bool
+run_aoc2025_bench(const char *runs, const char *isa, const char *output_path)
+{
+    printf("\nBenchmarking \""AOC2025_BIN"\" (%s runs per solver, %s solvers)...\n", runs, isa ? isa : "auto");
+    fflush(stdout);
+
+    Cmd cmd = {0};
+    cmd_append(&cmd, AOC2025_BIN, "--bench", runs);
+    if (isa) cmd_append(&cmd, "--isa", isa);
+    bool return_val = cmd_run(&cmd, .stdout_path = output_path);
+    da_free(cmd);
+    return return_val;
+}
+
+// Builds the baseline and the profile the final build is optimized with
+static inline bool
+train_pgo_profile(void)
+{
+    bool return_val = true;
+
+    File_Paths files = {0};
+    Cmd        cmd   = {0};
+
+    // Old profiles would not match the sources anymore
+    if (file_exists(PGO_DIR)) DO_OR_FAIL(delete_tree(PGO_DIR));
+    DO_OR_FAIL(mkdir_if_not_exists(PGO_DIR));
+
+    printf("\n == PGO: baseline build ==\n"); fflush(stdout);
+    pgo_phase = PGO_OFF;
+    DO_OR_FAIL(build_aoc2025_for_profiling());
+    DO_OR_FAIL(run_aoc2025_bench(PGO_BENCH_RUNS, NULL, PGO_BASELINE_BENCH));
+
+    printf("\n == PGO: instrumented build ==\n"); fflush(stdout);
+    pgo_phase = PGO_GENERATE;
+    DO_OR_FAIL(build_aoc2025_for_profiling());
+    // Every level has its own build of the day sources, each one is trained
+    // on its own. The app refuses the levels this cpu does not support, every
+    // x86-64 cpu runs the baseline.
+    for (size_t i = 0; i < ARRAY_LENGTH(solver_isas); ++i) {
+        const char *output_path = temp_sprintf(PGO_TRAINING_BENCH_FORMAT, solver_isas[i].name);
+        solver_isa_trained[i] = run_aoc2025_bench(PGO_TRAINING_RUNS, solver_isas[i].name, output_path);
+        if (i == 0) DO_OR_FAIL(solver_isa_trained[i]);
+        else if (!solver_isa_trained[i]) {
+            printf("The %s solvers did not run on this cpu, they are built without the profile\n", solver_isas[i].name);
+        }
+    }
+
+#ifndef _MSC_VER
+    // gcc reads its .gcda files directly, clang wants the raw profiles merged
+    if (cli.compiler == COMPILER_CLANG) {
+        cmd_append(&cmd, "llvm-profdata", "merge", "-o", PGO_PROFDATA);
+        DO_OR_FAIL(read_entire_dir(PGO_DIR, &files));
+        da_foreach(const char *, file, &files) {
+            if (sv_end_with(sv_from_cstr(*file), ".profraw")) cmd_append(&cmd, temp_sprintf(PGO_DIR"/%s", *file));
+        }
+        DO_OR_FAIL(cmd_run_sync_and_reset(&cmd));
+    }
+#endif
+
+    printf("\n == PGO: optimized build ==\n"); fflush(stdout);
+    pgo_phase = PGO_USE;
+
+done:
+    da_free(files);
+    da_free(cmd);
+    return return_val;
+}
+
+typedef struct {
+    char     solver[32];
+    char     input[16];
+    uint64_t median_ns;
+} BenchResult;
+
+typedef struct {
+    BenchResult *items;
+    size_t       capacity;
+    size_t       count;
+} BenchResults;
+
+// Parses the table `aoc2025 --bench` prints, skipping its header
+static inline bool
+read_bench_results(const char *path, BenchResults *out)
+{
+    String_Builder sb = {0};
+    if (!read_entire_file(path, &sb)) return false;
+    sb_append_null(&sb);
+
+    const char *line = strchr(sb.items, '\n');
+    while (line && *++line) {
+        BenchResult        result = {0};
+        unsigned           runs;
+        unsigned long long min_ns, median_ns;
+        if (sscanf(line, "%31s %15s %u %llu %llu", result.solver, result.input, &runs, &min_ns, &median_ns) == 5) {
+            result.median_ns = median_ns;
+            da_append(out, result);
+        }
+        line = strchr(line, '\n');
+    }
+
+    sb_free(sb);
+    return true;
+}
+
+static inline const BenchResult *
+find_bench_result(const BenchResults *results, const char *solver, const char *input)
+{
+    da_foreach(BenchResult, result, results) {
+        if (strcmp(result->solver, solver) == 0 && strcmp(result->input, input) == 0) return result;
+    }
+    return NULL;
+}
+
+// Solvers are named dayN_partM, and dayN_solve_both for both parts at once
+static inline bool
+same_day(const char *solver, const char *other)
+{
+    size_t length = strcspn(solver, "_");
+    return length == strcspn(other, "_") && strncmp(solver, other, length) == 0;
+}
+
+static inline bool
+is_part_solver(const char *solver)
+{
+    return strstr(solver, "_part") != NULL;
+}
+
+static inline void
+print_pgo_row(const char *name, const char *input, uint64_t before_ns, uint64_t after_ns)
+{
+    printf("%-15s %-10s %12.1f %12.1f %8.2fx\n", name, input, (double)before_ns / 1000.0, (double)after_ns / 1000.0,
+           after_ns ? (double)before_ns / (double)after_ns : 0.0);
+}
+
+// Median durations of the baseline and the optimized build, per solver and
+// summed over the real inputs per day
+static inline bool
+report_pgo_speedup(void)
+{
+    bool return_val = true;
+
+    BenchResults before = {0};
+    BenchResults after  = {0};
+
+    DO_OR_FAIL(run_aoc2025_bench(PGO_BENCH_RUNS, NULL, PGO_OPTIMIZED_BENCH));
+    DO_OR_FAIL(read_bench_results(PGO_BASELINE_BENCH, &before));
+    DO_OR_FAIL(read_bench_results(PGO_OPTIMIZED_BENCH, &after));
+
+    printf("\n == PGO SPEEDUP ==\n");
+    printf("%-15s %-10s %12s %12s %9s\n", "solver", "input", "before (us)", "after (us)", "speedup");
+    da_foreach(BenchResult, result, &before) {
+        const BenchResult *optimized = find_bench_result(&after, result->solver, result->input);
+        if (optimized) print_pgo_row(result->solver, result->input, result->median_ns, optimized->median_ns);
+    }
+
+    printf("\n");
+    for (size_t i = 0; i < before.count; ++i) {
+        // Each day once, in the order the benchmark ran them
+        bool seen = false;
+        for (size_t j = 0; j < i; ++j) seen = seen || same_day(before.items[j].solver, before.items[i].solver);
+        if (seen) continue;
+
+        uint64_t before_ns = 0, after_ns = 0;
+        da_foreach(BenchResult, result, &before) {
+            if (!same_day(result->solver, before.items[i].solver) || strcmp(result->input, "real") != 0) continue;
+            if (!is_part_solver(result->solver)) continue; // Would count its day twice
+            const BenchResult *optimized = find_bench_result(&after, result->solver, result->input);
+            if (!optimized) continue;
+            before_ns += result->median_ns;
+            after_ns  += optimized->median_ns;
+        }
+        const char *solver = before.items[i].solver;
+        print_pgo_row(temp_sprintf("%.*s", (int)strcspn(solver, "_"), solver), "real", before_ns, after_ns);
+    }
+    fflush(stdout);
+
+done:
+    da_free(before);
+    da_free(after);
+    return return_val;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -1278,6 +2227,8 @@ main(int argc, char **argv)
 
     Cmd cmd = {0};
     CompilationBlocks blocks = {0};
+    CompilationBlocks solver_blocks = {0};
+    CompilationBlocks headless_blocks = {0};
     Cmds compile_commands = {0};
 
     int return_val = EXIT_SUCCESS;
@@ -1310,8 +2261,16 @@ main(int argc, char **argv)
         }
     }
 
+    const uint64_t before_pgo_training_ns = nanos_since_unspecified_epoch();
+    if (cli.pgo && !train_pgo_profile()) {
+        return_val = EXIT_FAILURE;
+        goto done;
+    }
+    const uint64_t after_pgo_training_ns = nanos_since_unspecified_epoch();
+    const uint64_t pgo_training_time = after_pgo_training_ns - before_pgo_training_ns;
+
     const uint64_t before_generate_stuff_ns = nanos_since_unspecified_epoch();
-    if (!generate_stuff(&blocks, &compile_commands)) {
+    if (!generate_stuff(&blocks, &solver_blocks, &headless_blocks, &compile_commands)) {
         return_val = EXIT_FAILURE;
         goto done;
     }
@@ -1332,13 +2291,30 @@ main(int argc, char **argv)
     const uint64_t compilation_time = after_compilation_ns - before_compilation_ns;
 
     const uint64_t before_linking_ns = nanos_since_unspecified_epoch();
-    if(!link_aoc2025(&blocks)) {
+    if (!cli.solvers_only && !archive_aoc_solvers(&solver_blocks)) {
+        return_val = EXIT_FAILURE;
+        goto done;
+    }
+    if (!cli.solvers_only && !link_aoc2025(&blocks)) {
+        return_val = EXIT_FAILURE;
+        goto done;
+    }
+    if (!cli.solvers_only && !link_aoc_solve(&headless_blocks)) {
+        return_val = EXIT_FAILURE;
+        goto done;
+    }
+    if (cli.hot_reload && !link_aoc2025_solvers(&solver_blocks)) {
         return_val = EXIT_FAILURE;
         goto done;
     }
     const uint64_t after_linking_ns = nanos_since_unspecified_epoch();
     const uint64_t linking_time = after_linking_ns - before_linking_ns;
 
+    if (cli.pgo && !report_pgo_speedup()) {
+        return_val = EXIT_FAILURE;
+        goto done;
+    }
+
     const uint64_t before_package_ns = nanos_since_unspecified_epoch();
     if (cli.package) {
         if (!package_distribution()) {
@@ -1376,20 +2352,25 @@ main(int argc, char **argv)
     const size_t    linking_time_fmt_len        = strlen(linking_time_fmt);
     const char     *package_time_fmt            = temp_sprintf("%.4f", (double)package_time     / NANOS_PER_SEC);
     const size_t    package_time_fmt_len        = strlen(package_time_fmt);
-    const uint64_t  total_time                  = generate_stuff_time + compilation_time + linking_time + (cli.package ? package_time : 0);
+    const char     *pgo_training_time_fmt       = temp_sprintf("%.4f", (double)pgo_training_time / NANOS_PER_SEC);
+    const size_t    pgo_training_time_fmt_len   = strlen(pgo_training_time_fmt);
+    const uint64_t  total_time                  = generate_stuff_time + compilation_time + linking_time + (cli.package ? package_time : 0) + (cli.pgo ? pgo_training_time : 0);
     const char     *total_time_fmt              = temp_sprintf("%.4f", (double)total_time  / NANOS_PER_SEC);
     const size_t    total_time_fmt_len          = strlen(total_time_fmt);
     size_t          longest_num                 = generate_stuff_time_fmt_len;
     if (compilation_time_fmt_len > longest_num) longest_num = compilation_time_fmt_len;
     if (linking_time_fmt_len > longest_num) longest_num = linking_time_fmt_len;
     if (cli.package && package_time_fmt_len > longest_num) longest_num = package_time_fmt_len;
+    if (cli.pgo && pgo_training_time_fmt_len > longest_num) longest_num = pgo_training_time_fmt_len;
     if (total_time_fmt_len > longest_num) longest_num = total_time_fmt_len;
     const size_t generate_stuff_time_pad  = longest_num - generate_stuff_time_fmt_len;
     const size_t compilation_time_pad = longest_num - compilation_time_fmt_len;
     const size_t linking_time_pad = longest_num - linking_time_fmt_len;
     const size_t package_time_pad     = longest_num - package_time_fmt_len;
+    const size_t pgo_training_time_pad = longest_num - pgo_training_time_fmt_len;
     const size_t total_time_pad       = longest_num - total_time_fmt_len;
     printf("\n == Timing ==\n");
+    if (cli.pgo) printf("Profiling...: %*s%s seconds\n", (int)pgo_training_time_pad, "", pgo_training_time_fmt);
     printf("Generation..: %*s%s seconds\n", (int)generate_stuff_time_pad, "", generate_stuff_time_fmt);
     printf("Compilation.: %*s%s seconds\n", (int)compilation_time_pad, "", compilation_time_fmt);
     printf("Linking.....: %*s%s seconds\n", (int)linking_time_pad, "", linking_time_fmt);
@@ -1402,7 +2383,9 @@ main(int argc, char **argv)
     temp_rewind(checkpoint);
 
     printf("\n\n == BUILD ARTIFACTS ==\n");
-    printf("Built binary: \""AOC2025_BIN"\". (Run from root directory of source tree)\n");
+    if (!cli.solvers_only) printf("Built binary: \""AOC2025_BIN"\". (Run from root directory of source tree)\n");
+    if (!cli.solvers_only) printf("Built headless solver library: \""AOC_SOLVERS_ARCHIVE"\" and its command line front end \""AOC_SOLVE_BIN"\".\n");
+    if (cli.hot_reload)    printf("Built solver library: \""AOC2025_SOLVERS_LIB"\". (Reloaded by a running Aoc2025)\n");
     if (cli.package) {
         printf("Archived distribution: \""AOC2025_DISTRIBUTION_ARCHIVE"\"\n");
         printf("SHA256 sum of archive: \""AOC2025_DISTRIBUTION_HASH_FILE"\"\n");
@@ -1426,6 +2409,8 @@ main(int argc, char **argv)
 done:
     da_free(compile_commands);
     da_free(blocks);
+    da_free(solver_blocks);
+    da_free(headless_blocks);
     da_free(cmd);
     destroy_cli();
 
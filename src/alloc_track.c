@@ -0,0 +1,194 @@
+#include "alloc_track.h"
+
+#ifdef AOC2025_ALLOC_TRACK
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <malloc.h>
+
+#define ALLOC_TRACK_MAX_SITES 256 // Per tracked run, further sites are only counted in the totals
+
+// Locked for every update, as workers attached to it count in parallel
+struct AllocTracker {
+    volatile u32 lock;
+    AllocStats   stats;
+    s64          live_bytes;
+    u32          site_count;
+    AllocSite    sites[ALLOC_TRACK_MAX_SITES];
+};
+
+static THREAD_LOCAL AllocTracker *alloc_tracker = NULL;
+
+// Sizes come from the allocator, so blocks allocated before tracking began
+// can be freed while tracking, and tracked blocks freed by anyone
+static usize
+allocation_size(void *pointer)
+{
+    if (!pointer) return 0;
+#ifdef _MSC_VER
+    return _msize(pointer);
+#else
+    return malloc_usable_size(pointer);
+#endif
+}
+
+static void
+record_allocation(AllocTracker *tracker, usize size, void *pointer, const char *file, u32 line)
+{
+    spin_lock(&tracker->lock);
+    tracker->stats.alloc_count += 1;
+    tracker->stats.bytes       += size;
+    tracker->live_bytes        += (s64)allocation_size(pointer);
+    if (tracker->live_bytes > 0 && (u64)tracker->live_bytes > tracker->stats.peak_live_bytes) {
+        tracker->stats.peak_live_bytes = (u64)tracker->live_bytes;
+    }
+
+    // Few distinct sites per run, a linear search is fine
+    for (u32 i = 0; i < tracker->site_count; ++i) {
+        AllocSite *site = &tracker->sites[i];
+        if (site->line == line && site->file == file) {
+            site->count += 1;
+            site->bytes += size;
+            spin_unlock(&tracker->lock);
+            return;
+        }
+    }
+    if (tracker->site_count < ALLOC_TRACK_MAX_SITES) {
+        tracker->sites[tracker->site_count++] = (AllocSite){file, line, 1, size};
+    }
+    spin_unlock(&tracker->lock);
+}
+
+static void
+record_free(AllocTracker *tracker, usize size)
+{
+    spin_lock(&tracker->lock);
+    tracker->stats.free_count += 1;
+    tracker->live_bytes       -= (s64)size;
+    spin_unlock(&tracker->lock);
+}
+
+void
+alloc_track_begin(void)
+{
+    AllocTracker *tracker = (AllocTracker *)calloc(1, sizeof(*tracker));
+    alloc_tracker = tracker;
+}
+
+void
+alloc_track_end(AllocStats *stats)
+{
+    AllocTracker *tracker = alloc_tracker;
+    alloc_tracker = NULL;
+    if (!tracker) return;
+
+    *stats = tracker->stats;
+    // Selection of the most frequent sites, there are only a few
+    for (u32 top = 0; top < ALLOC_TRACK_TOP_SITES && top < tracker->site_count; ++top) {
+        u32 best = top;
+        for (u32 i = top + 1; i < tracker->site_count; ++i) {
+            if (tracker->sites[i].count > tracker->sites[best].count) best = i;
+        }
+        AllocSite site        = tracker->sites[best];
+        tracker->sites[best]  = tracker->sites[top];
+        tracker->sites[top]   = site;
+        stats->top_sites[top] = site;
+        stats->site_count     = top + 1;
+    }
+    free(tracker);
+}
+
+AllocTracker *
+alloc_track_current(void)
+{
+    return alloc_tracker;
+}
+
+AllocTracker *
+alloc_track_attach(AllocTracker *tracker)
+{
+    AllocTracker *previous = alloc_tracker;
+    alloc_tracker = tracker;
+    return previous;
+}
+
+void *
+alloc_track_malloc(usize size, const char *file, u32 line)
+{
+    void *pointer = malloc(size);
+    if (alloc_tracker && pointer) record_allocation(alloc_tracker, size, pointer, file, line);
+    return pointer;
+}
+
+void *
+alloc_track_calloc(usize count, usize size, const char *file, u32 line)
+{
+    void *pointer = calloc(count, size);
+    if (alloc_tracker && pointer) record_allocation(alloc_tracker, count*size, pointer, file, line);
+    return pointer;
+}
+
+void *
+alloc_track_realloc(void *pointer, usize size, const char *file, u32 line)
+{
+    AllocTracker *tracker  = alloc_tracker;
+    usize         old_size = tracker ? allocation_size(pointer) : 0;
+    void         *result   = realloc(pointer, size);
+    if (tracker && result) {
+        // Not a free, the realloc itself counts as one allocation
+        spin_lock(&tracker->lock);
+        tracker->live_bytes -= (s64)old_size;
+        spin_unlock(&tracker->lock);
+        record_allocation(tracker, size, result, file, line);
+    }
+    return result;
+}
+
+void
+alloc_track_free(void *pointer)
+{
+    AllocTracker *tracker = alloc_tracker;
+    if (tracker && pointer) record_free(tracker, allocation_size(pointer));
+    free(pointer);
+}
+
+char *
+alloc_track_sprint(const char *file, u32 line, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    s32 need = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+    if (need < 0) return NULL;
+
+    char *buffer = (char *)alloc_track_malloc((usize)need + 1, file, line);
+
+    va_start(args, fmt);
+    vsnprintf(buffer, (size_t)need + 1, fmt, args);
+    va_end(args);
+
+    return buffer;
+}
+
+char *
+alloc_track_u64_string(u64 value, const char *file, u32 line)
+{
+    char  digits[INT_ASCII_BUFFER_SIZE];
+    usize length = u64_to_ascii(value, digits);
+    char *buffer = (char *)alloc_track_malloc(length + 1, file, line);
+    memcpy(buffer, digits, length + 1);
+    return buffer;
+}
+
+char *
+alloc_track_s64_string(s64 value, const char *file, u32 line)
+{
+    char  digits[INT_ASCII_BUFFER_SIZE];
+    usize length = s64_to_ascii(value, digits);
+    char *buffer = (char *)alloc_track_malloc(length + 1, file, line);
+    memcpy(buffer, digits, length + 1);
+    return buffer;
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef ALLOC_TRACK_H
+#define ALLOC_TRACK_H
+
+#include "basic.h"
+#include "days.h"
+
+// Allocation tracker for solver runs. Between alloc_track_begin() and
+// alloc_track_end() the calling thread's malloc, calloc, realloc, free,
+// sprint, u64_string and s64_string calls from redirected source files are
+// counted, with the call sites that allocate most often. Compiled out unless
+// AOC2025_ALLOC_TRACK is defined (`bs --track-allocations`), and the
+// counting makes runs slower.
+// Hot reloaded solvers count into the library's own tracker, which the app
+// looks up by name like the solvers. Parts of a solver that run on pool
+// workers (parallel_lines.h) count into the solver's tracker while they run.
+
+#define ALLOC_TRACK_TOP_SITES 3
+
+typedef struct AllocTracker AllocTracker;
+
+typedef struct {
+    const char *file; // As __FILE__ at the call site
+    u32         line;
+    u64         count;
+    u64         bytes;
+} AllocSite;
+
+typedef struct {
+    u64       alloc_count;     // malloc, calloc, realloc, sprint and _string calls
+    u64       free_count;
+    u64       bytes;           // Requested by all of them together
+    u64       peak_live_bytes; // Most allocated at once, counting only what was allocated while tracking
+    u32       site_count;      // Of top_sites used, most frequent first
+    AllocSite top_sites[ALLOC_TRACK_TOP_SITES];
+} AllocStats;
+
+#ifdef AOC2025_ALLOC_TRACK
+
+SOLVER_EXPORT void alloc_track_begin(void);
+SOLVER_EXPORT void alloc_track_end(AllocStats *stats);
+
+// The calling thread's tracker, NULL if it is not tracking
+AllocTracker *alloc_track_current(void);
+// Counts the calling thread's allocations into tracker, which another thread
+// got from alloc_track_current() and does not end meanwhile. Returns the
+// tracker it replaces, to attach again afterwards.
+AllocTracker *alloc_track_attach(AllocTracker *tracker);
+
+void *alloc_track_malloc(usize size, const char *file, u32 line);
+void *alloc_track_calloc(usize count, usize size, const char *file, u32 line);
+void *alloc_track_realloc(void *pointer, usize size, const char *file, u32 line);
+void  alloc_track_free(void *pointer);
+char *alloc_track_sprint(const char *file, u32 line, const char *fmt, ...);
+char *alloc_track_u64_string(u64 value, const char *file, u32 line);
+char *alloc_track_s64_string(s64 value, const char *file, u32 line);
+
+#define ALLOC_TRACK_BEGIN()    alloc_track_begin()
+#define ALLOC_TRACK_END(stats) alloc_track_end(stats)
+
+#else
+
+#define ALLOC_TRACK_BEGIN()
+#define ALLOC_TRACK_END(stats)
+
+static inline AllocTracker *
+alloc_track_current(void)
+{
+    return NULL;
+}
+
+static inline AllocTracker *
+alloc_track_attach(AllocTracker *tracker)
+{
+    UNUSED(tracker)
+    return NULL;
+}
+
+#endif
+
+#endif
+
+// Source files whose allocations should be counted define
+// ALLOC_TRACK_REDIRECT before including this, after the headers that
+// declare malloc and sprint
+#if defined(AOC2025_ALLOC_TRACK) && defined(ALLOC_TRACK_REDIRECT) && !defined(ALLOC_TRACK_REDIRECTED)
+#define ALLOC_TRACK_REDIRECTED
+#define malloc(size)           alloc_track_malloc((size), __FILE__, __LINE__)
+#define calloc(count, size)    alloc_track_calloc((count), (size), __FILE__, __LINE__)
+#define realloc(pointer, size) alloc_track_realloc((pointer), (size), __FILE__, __LINE__)
+#define free(pointer)          alloc_track_free(pointer)
+#define sprint(...)            alloc_track_sprint(__FILE__, __LINE__, __VA_ARGS__)
+#define u64_string(value)      alloc_track_u64_string((value), __FILE__, __LINE__)
+#define s64_string(value)      alloc_track_s64_string((value), __FILE__, __LINE__)
+#endif
@@ -1,181 +1,1567 @@
 #include "aoc2025.h"
 #include "days.h"
+#include "embedded.h"
+#include "runner.h"
+#include "trace.h"
 
 #include "raylib.h"
 #include "clay.h"
 #include "clay_renderer_raylib.c"
+#define GLFW_INCLUDE_NONE
+#include "GLFW/glfw3.h"
+
+#define CAP_IMPLEMENTATION
+#define CAPDEF static inline
+#include "cap.h"
 
 #include <stdio.h>
 
-typedef char *(*ProblemFunc)(const char*, usize);
+#define RESULT_CACHE_DIR "build/cache/results"
+
+// With hot reloading the solvers live in a shared library, and are bound by
+// name when it is loaded
+#ifdef AOC2025_HOT_RELOAD
+#define SOLVER(func) NULL
+#else
+#define SOLVER(func) func
+#endif
+
+// Clay's default of 16384 words is outgrown by the descriptions and input
+// viewer, and growing it on overflow re-creates the Clay context
+#define MEASURE_TEXT_CACHE_WORD_COUNT (1 << 16)
+
+// Number of runs behind the min/median shown after pressing a repeat button
+#define RUN_REPEAT_COUNT 10
+#define RUN_REPEAT_LABEL "Repeat x10"
+
+struct {
+    const char *day_button_title;
+
+    const char *title_file;
+    Clay_String title;
+
+    const char  *part1_name;
+    ProblemFunc  part1_func;
+    const char  *part1_description_file;
+    Clay_String  part1_description;
+    const char  *part1_test_data_file;
+    Clay_String  part1_test_data;
+    const char  *part1_real_data_file;
+    Clay_String  part1_real_data;
+    RunJob       part1_test_job;
+    RunJob       part1_real_job;
+
+    const char  *part2_name;
+    ProblemFunc  part2_func;
+    const char  *part2_description_file;
+    Clay_String  part2_description;
+    const char  *part2_test_data_file;
+    Clay_String  part2_test_data;
+    const char  *part2_real_data_file;
+    Clay_String  part2_real_data;
+    RunJob       part2_test_job;
+    RunJob       part2_real_job;
+
+    const char    *solve_both_name; // Optional, both parts in one pass for run all and --bench
+    SolveBothFunc  solve_both_func;
+
+    bool         part2_grid_visualizer; // Part 2 publishes GridFrames, see day4_set_grid_frames
+} days[] = {
+    { .day_button_title       = "Day 1",
+      .title_file             = "data/day1/title.txt",
+      .part1_description_file = "data/day1/part1_description.txt",
+      .part1_test_data_file   = "data/day1/test_data.txt",
+      .part1_real_data_file   = "data/day1/real_data.txt",
+      .part1_name             = "day1_part1",
+      .part1_func             = SOLVER(day1_part1),
+      .part2_description_file = "data/day1/part2_description.txt",
+      .part2_test_data_file   = "data/day1/test_data.txt",
+      .part2_real_data_file   = "data/day1/real_data.txt",
+      .part2_name             = "day1_part2",
+      .part2_func             = SOLVER(day1_part2),
+      .solve_both_name        = "day1_solve_both",
+      .solve_both_func        = SOLVER(day1_solve_both)},
+
+    { .day_button_title       = "Day 2",
+      .title_file             = "data/day2/title.txt",
+      .part1_description_file = "data/day2/part1_description.txt",
+      .part1_test_data_file   = "data/day2/test_data.txt",
+      .part1_real_data_file   = "data/day2/real_data.txt",
+      .part1_name             = "day2_part1",
+      .part1_func             = SOLVER(day2_part1),
+      .part2_description_file = "data/day2/part2_description.txt",
+      .part2_test_data_file   = "data/day2/test_data.txt",
+      .part2_real_data_file   = "data/day2/real_data.txt",
+      .part2_name             = "day2_part2",
+      .part2_func             = SOLVER(day2_part2),
+      .solve_both_name        = "day2_solve_both",
+      .solve_both_func        = SOLVER(day2_solve_both)},
+
+    { .day_button_title       = "Day 3",
+      .title_file             = "data/day3/title.txt",
+      .part1_description_file = "data/day3/part1_description.txt",
+      .part1_test_data_file   = "data/day3/test_data.txt",
+      .part1_real_data_file   = "data/day3/real_data.txt",
+      .part1_name             = "day3_part1",
+      .part1_func             = SOLVER(day3_part1),
+      .part2_description_file = "data/day3/part2_description.txt",
+      .part2_test_data_file   = "data/day3/test_data.txt",
+      .part2_real_data_file   = "data/day3/real_data.txt",
+      .part2_name             = "day3_part2",
+      .part2_func             = SOLVER(day3_part2),
+      .solve_both_name        = "day3_solve_both",
+      .solve_both_func        = SOLVER(day3_solve_both)},
+
+    { .day_button_title       = "Day 4",
+      .title_file             = "data/day4/title.txt",
+      .part1_description_file = "data/day4/part1_description.txt",
+      .part1_test_data_file   = "data/day4/test_data.txt",
+      .part1_real_data_file   = "data/day4/real_data.txt",
+      .part1_name             = "day4_part1",
+      .part1_func             = SOLVER(day4_part1),
+      .part2_description_file = "data/day4/part2_description.txt",
+      .part2_test_data_file   = "data/day4/test_data.txt",
+      .part2_real_data_file   = "data/day4/real_data.txt",
+      .part2_name             = "day4_part2",
+      .part2_func             = SOLVER(day4_part2),
+      .solve_both_name        = "day4_solve_both",
+      .solve_both_func        = SOLVER(day4_solve_both),
+      .part2_grid_visualizer  = true},
+
+    { .day_button_title       = "Day 5",
+      .title_file             = "data/day5/title.txt",
+      .part1_description_file = "data/day5/part1_description.txt",
+      .part1_test_data_file   = "data/day5/test_data.txt",
+      .part1_real_data_file   = "data/day5/real_data.txt",
+      .part1_name             = "day5_part1",
+      .part1_func             = SOLVER(day5_part1),
+      .part2_description_file = "data/day5/part2_description.txt",
+      .part2_test_data_file   = "data/day5/test_data.txt",
+      .part2_real_data_file   = "data/day5/real_data.txt",
+      .part2_name             = "day5_part2",
+      .part2_func             = SOLVER(day5_part2)},
+};
+
+static Clay_String
+embedded_string(const char *path)
+{
+    const EmbeddedFile *file = embedded_file(path);
+    if (!file) {
+        fprintf(stderr, "\"%s\" was not embedded\n", path);
+        return (Clay_String){.chars = ""};
+    }
+    return (Clay_String){.chars = (const char *)file->data, .length = (s32)file->size};
+}
+
+// The files are compiled in, so this only points the strings at them
+static void
+load_day_data(void)
+{
+    for (usize i = 0; i < ARRAY_LENGTH(days); ++i) {
+        days[i].title             = embedded_string(days[i].title_file);
+        days[i].part1_description = embedded_string(days[i].part1_description_file);
+        days[i].part1_test_data   = embedded_string(days[i].part1_test_data_file);
+        days[i].part1_real_data   = embedded_string(days[i].part1_real_data_file);
+        days[i].part2_description = embedded_string(days[i].part2_description_file);
+        days[i].part2_test_data   = embedded_string(days[i].part2_test_data_file);
+        days[i].part2_real_data   = embedded_string(days[i].part2_real_data_file);
+    }
+}
+
+
+
+const uint32_t FONT_ID_BODY_24 = 0;
+const uint32_t FONT_ID_BODY_16 = 1;
+const uint32_t FONT_ID_MONO_16 = 2;
+#define COLOR_ORANGE (Clay_Color){225, 138, 50, 255}
+#define COLOR_BLUE   (Clay_Color){111, 173, 162, 255}
+
+// COLORS
+#define BG_COLOR                (Clay_Color){13, 17, 22, 255}
+#define SURFACE_COLOR           (Clay_Color){22, 27, 34, 255}
+#define SURFACE_HIGHLIGHT_COLOR (Clay_Color){30, 36, 45, 255}
+
+#define PRIMARY_ACCENT_COLOR (Clay_Color){74, 179, 244, 255}
+#define SECONDARY_ACCENT_COLOR (Clay_Color){107, 214, 255, 255}
+
+#define PRIMARY_TEXT_COLOR (Clay_Color){229, 233, 240, 255}
+#define SECONDARY_TEXT_COLOR (Clay_Color){169, 180, 198, 255}
+#define ACCENT_TEXT_COLOR (Clay_Color){10, 14, 18, 255}
+
+Texture2D aoc_icon;
+
+#define RAYLIB_VECTOR2_TO_CLAY_VECTOR2(vector) (Clay_Vector2){.x = vector.x, .y = vector.y}
+
+Clay_TextElementConfig headerTextConfig = {.fontId = 1, .letterSpacing = 5, .fontSize = 16, .textColor = {0,0,0,255}};
+
+static usize active_day_index    = 0;
+static u32   active_problem_part = 1;
+
+static void
+handle_day_button_interaction(Clay_ElementId   element_id,
+                              Clay_PointerData pointer_info,
+                              intptr_t         user_data)
+{
+    UNUSED(element_id);
+    usize index = (usize)user_data;
+    if (pointer_info.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        if (index <= ARRAY_LENGTH(days)) {
+            active_day_index = index;
+            active_problem_part = 1;
+        }
+    }
+}
+
+static void
+handle_part_button_interaction(Clay_ElementId   element_id,
+                               Clay_PointerData pointer_info,
+                               intptr_t         user_data)
+{
+    UNUSED(element_id);
+    u32 part = (u32)user_data;
+    if (pointer_info.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        if (part == 1) active_problem_part = 1;
+        else           active_problem_part = 2;
+    }
+}
+
+static ThreadPool *thread_pool;
+
+static RunJob *
+day_job(usize day_index, u32 part, bool test)
+{
+    if (part == 1) return test ? &days[day_index].part1_test_job : &days[day_index].part1_real_job;
+    else           return test ? &days[day_index].part2_test_job : &days[day_index].part2_real_job;
+}
+
+static Clay_String
+day_input(usize day_index, u32 part, bool test)
+{
+    if (part == 1) return test ? days[day_index].part1_test_data : days[day_index].part1_real_data;
+    else           return test ? days[day_index].part2_test_data : days[day_index].part2_real_data;
+}
+
+static ProblemFunc
+day_func(usize day_index, u32 part)
+{
+    return (part == 1) ? days[day_index].part1_func : days[day_index].part2_func;
+}
+
+static const char *
+day_solver_name(usize day_index, u32 part)
+{
+    return (part == 1) ? days[day_index].part1_name : days[day_index].part2_name;
+}
+
+static bool
+submit_day_job(usize day_index, u32 part, bool test, u32 repeat_count, RunJobCallback on_complete)
+{
+    Clay_String input = day_input(day_index, part, test);
+    return run_job_submit(thread_pool, day_job(day_index, part, test), day_solver_name(day_index, part),
+                          day_func(day_index, part), input.chars, (usize)input.length, repeat_count, on_complete);
+}
+
+// Both parts with the day's SolveBothFunc, if it has one and they share their
+// input. Returns false, and does nothing, otherwise or if either job is running.
+static bool
+submit_day_jobs_both(usize day_index, bool test, u32 repeat_count, RunJobCallback on_complete)
+{
+    Clay_String part1_input = day_input(day_index, 1, test);
+    Clay_String part2_input = day_input(day_index, 2, test);
+    if (!days[day_index].solve_both_func || part1_input.length != part2_input.length ||
+        memcmp(part1_input.chars, part2_input.chars, (usize)part1_input.length) != 0) {
+        return false;
+    }
+    return run_job_submit_both(thread_pool, day_job(day_index, 1, test), day_job(day_index, 2, test),
+                               day_solver_name(day_index, 1), day_solver_name(day_index, 2),
+                               days[day_index].solve_both_func, part1_input.chars, (usize)part1_input.length,
+                               repeat_count, on_complete);
+}
+
+static void
+run_active_problem(bool test, u32 repeat_count)
+{
+    submit_day_job(active_day_index, active_problem_part, test, repeat_count, NULL);
+}
+
+
+static GridFrames *grid_visualizer_frames(void);
+static RunJob     *grid_visualizer_job(void);
+
+// Cancels every job still running a solver, returns whether there were any
+static bool
+cancel_solver_jobs(void)
+{
+    bool any_running = false;
+    for (usize i = 0; i < ARRAY_LENGTH(days); ++i) {
+        for (u32 part = 1; part <= 2; ++part) {
+            for (int test = 0; test <= 1; ++test) {
+                RunJob *job = day_job(i, part, (bool)test);
+                if (run_job_state(job) != RUN_JOB_RUNNING) continue;
+                run_job_cancel(job);
+                any_running = true;
+            }
+        }
+    }
+    if (run_job_state(grid_visualizer_job()) == RUN_JOB_RUNNING) {
+        run_job_cancel(grid_visualizer_job());
+        any_running = true;
+    }
+    return any_running;
+}
+
+#ifdef AOC2025_HOT_RELOAD
+// Hot reloading
+static struct {
+    void *library;
+    u64 (*build_id)(void);
+    bool (*set_isa)(Isa isa);
+    Isa  (*isa)(void);
+    void (*alloc_track_begin)(void);
+    void (*alloc_track_end)(AllocStats *stats);
+    void (*flush_parsed_inputs)(void);
+    Isa   requested_isa; // Set again on every reloaded library
+    bool  reload_pending; // The library changed, waiting for running jobs to stop
+    char  loaded_path[256];
+    u64   modified_time;
+    u32   generation;
+} solver_library = {.requested_isa = ISA_AUTO};
+
+// Keys the result cache on the loaded library, so reloaded solvers are re-run
+u64
+solver_build_id(void)
+{
+    return solver_library.build_id ? solver_library.build_id() : 0;
+}
+
+bool
+solvers_set_isa(Isa isa)
+{
+    if (!solver_library.set_isa || !solver_library.set_isa(isa)) return false;
+    solver_library.requested_isa = isa;
+    return true;
+}
+
+Isa
+solvers_isa(void)
+{
+    return solver_library.isa ? solver_library.isa() : ISA_BASELINE;
+}
+
+#ifdef AOC2025_ALLOC_TRACK
+// The solvers allocate through the library's tracker, not one of the app's
+void
+alloc_track_begin(void)
+{
+    if (solver_library.alloc_track_begin) solver_library.alloc_track_begin();
+}
+
+void
+alloc_track_end(AllocStats *stats)
+{
+    if (solver_library.alloc_track_end) solver_library.alloc_track_end(stats);
+}
+#endif
+
+static bool
+load_solver_library(void)
+{
+    solver_library.modified_time = file_modified_time(solver_library_path);
+    if (solver_library.modified_time == 0) {
+        fprintf(stderr, "Could not find solver library \"%s\", build it with `bs --hot-reload`\n", solver_library_path);
+        return false;
+    }
+
+    // Load a copy, so bs can replace the library while it is loaded, and the
+    // loader can not hand back the previous version from its cache
+    char loaded_path[sizeof(solver_library.loaded_path)];
+    snprintf(loaded_path, sizeof(loaded_path), "%s.loaded%u", solver_library_path, solver_library.generation + 1);
+    if (!copy_file(solver_library_path, loaded_path)) {
+        fprintf(stderr, "Could not copy solver library to \"%s\"\n", loaded_path);
+        return false;
+    }
+    void *library = library_load(loaded_path);
+    if (!library) {
+        remove(loaded_path);
+        return false;
+    }
+
+    // Look everything up first, so a broken library leaves the old solvers in place
+    ProblemFunc   part1_funcs[ARRAY_LENGTH(days)];
+    ProblemFunc   part2_funcs[ARRAY_LENGTH(days)];
+    SolveBothFunc both_funcs[ARRAY_LENGTH(days)];
+    u64 (*build_id)(void) = (u64 (*)(void))library_symbol(library, "solver_build_id");
+    void (*set_grid_frames)(GridFrames *) = (void (*)(GridFrames *))library_symbol(library, "day4_set_grid_frames");
+    bool (*set_isa)(Isa) = (bool (*)(Isa))library_symbol(library, "solvers_set_isa");
+    Isa  (*isa)(void)    = (Isa (*)(void))library_symbol(library, "solvers_isa");
+    void (*flush_parsed_inputs)(void) = (void (*)(void))library_symbol(library, "solvers_flush_parsed_inputs");
+    const char *missing = build_id ? NULL : "solver_build_id";
+    if (!set_grid_frames)     missing = "day4_set_grid_frames";
+    if (!set_isa)             missing = "solvers_set_isa";
+    if (!isa)                 missing = "solvers_isa";
+    if (!flush_parsed_inputs) missing = "solvers_flush_parsed_inputs";
+#ifdef AOC2025_ALLOC_TRACK
+    void (*track_begin)(void)       = (void (*)(void))library_symbol(library, "alloc_track_begin");
+    void (*track_end)(AllocStats *) = (void (*)(AllocStats *))library_symbol(library, "alloc_track_end");
+    if (!track_begin) missing = "alloc_track_begin";
+    if (!track_end)   missing = "alloc_track_end";
+#endif
+    for (usize i = 0; i < ARRAY_LENGTH(days) && !missing; ++i) {
+        part1_funcs[i] = (ProblemFunc)library_symbol(library, days[i].part1_name);
+        part2_funcs[i] = (ProblemFunc)library_symbol(library, days[i].part2_name);
+        both_funcs[i]  = days[i].solve_both_name ? (SolveBothFunc)library_symbol(library, days[i].solve_both_name) : NULL;
+        if (!part1_funcs[i]) missing = days[i].part1_name;
+        if (!part2_funcs[i]) missing = days[i].part2_name;
+        if (days[i].solve_both_name && !both_funcs[i]) missing = days[i].solve_both_name;
+    }
+    if (missing) {
+        fprintf(stderr, "Solver library \"%s\" does not export \"%s\"\n", solver_library_path, missing);
+        library_unload(library);
+        remove(loaded_path);
+        return false;
+    }
+
+    // hot_reload_solvers() only gets here once no job runs the old library's
+    // code. Its cached parses are freed by its own code, or they would leak.
+    if (solver_library.library) {
+        solver_library.flush_parsed_inputs();
+        library_unload(solver_library.library);
+        remove(solver_library.loaded_path);
+    }
+
+    for (usize i = 0; i < ARRAY_LENGTH(days); ++i) {
+        days[i].part1_func      = part1_funcs[i];
+        days[i].part2_func      = part2_funcs[i];
+        days[i].solve_both_func = both_funcs[i];
+    }
+    set_grid_frames(grid_visualizer_frames());
+    set_isa(solver_library.requested_isa);
+    solver_library.library  = library;
+    solver_library.build_id = build_id;
+    solver_library.set_isa  = set_isa;
+    solver_library.isa      = isa;
+    solver_library.flush_parsed_inputs = flush_parsed_inputs;
+#ifdef AOC2025_ALLOC_TRACK
+    solver_library.alloc_track_begin = track_begin;
+    solver_library.alloc_track_end   = track_end;
+#endif
+    solver_library.generation += 1;
+    memcpy(solver_library.loaded_path, loaded_path, sizeof(loaded_path));
+
+    printf("Loaded solver library \"%s\" (build %016llx)\n", solver_library_path, (unsigned long long)build_id());
+    return true;
+}
+
+static void
+unload_solver_library(void)
+{
+    if (!solver_library.library) return;
+    solver_library.flush_parsed_inputs();
+    library_unload(solver_library.library);
+    remove(solver_library.loaded_path);
+    solver_library.library  = NULL;
+    solver_library.build_id = NULL;
+    solver_library.set_isa  = NULL;
+    solver_library.isa      = NULL;
+    solver_library.alloc_track_begin   = NULL;
+    solver_library.alloc_track_end     = NULL;
+    solver_library.flush_parsed_inputs = NULL;
+}
+
+// Called once per frame, a stat is cheap enough to not bother throttling.
+// Jobs still running the old library are cancelled and the reload waits for
+// them over the next frames, a finishing job wakes the main loop.
+static void
+hot_reload_solvers(void)
+{
+    if (!solver_library.reload_pending && file_modified_time(solver_library_path) == solver_library.modified_time) return;
+    solver_library.reload_pending = true;
+    if (cancel_solver_jobs()) return;
+    solver_library.reload_pending = false;
+    if (!load_solver_library()) return;
+
+    // Re-time whatever is on screen with the new code
+    for (int test = 0; test <= 1; ++test) {
+        RunJob *job = day_job(active_day_index, active_problem_part, (bool)test);
+        if (run_job_state(job) == RUN_JOB_DONE) {
+            submit_day_job(active_day_index, active_problem_part, (bool)test, job->repeat_count, NULL);
+        }
+    }
+}
+#endif
+
+
+// Run all
+static struct {
+    volatile u32 job_count; // RUN_ALL_SUBMITTING until every job is submitted
+    volatile u32 completed_count;
+    volatile u64 cpu_ns; // Sum of the solve times of all jobs
+    u64          begin_ns;
+    volatile u64 end_ns;
+    bool         started;
+} run_all;
+
+#define RUN_ALL_SUBMITTING UINT32_MAX
+
+static bool
+run_all_running(void)
+{
+    return run_all.started && atomic_load_u32(&run_all.completed_count) < atomic_load_u32(&run_all.job_count);
+}
+
+// Whoever sees the last job done first stamps the end, a completion or the
+// submitting thread once it knows the count
+static void
+run_all_finish_if_done(void)
+{
+    if (atomic_load_u32(&run_all.completed_count) < atomic_load_u32(&run_all.job_count)) return;
+    atomic_compare_exchange_u64(&run_all.end_ns, 0, time_now_ns());
+}
+
+static void
+handle_run_all_job_complete(RunJob *job)
+{
+    // Both jobs of a fused run carry the time of the one solve
+    bool fused_part2 = job->fused_job && !job->both_func;
+    if (!fused_part2) atomic_fetch_add_u64(&run_all.cpu_ns, job->result.solve_ns);
+    atomic_fetch_add_u32(&run_all.completed_count, 1);
+    run_all_finish_if_done();
+}
+
+static void
+run_all_problems(RunJobCallback on_complete)
+{
+    // A second press while running would mix both runs' completions
+    if (run_all_running()) return;
+
+    run_all.completed_count = 0;
+    run_all.cpu_ns          = 0;
+    run_all.end_ns          = 0;
+    atomic_store_u32(&run_all.job_count, RUN_ALL_SUBMITTING);
+    run_all.begin_ns        = time_now_ns();
+    run_all.started         = true;
+
+    // Only jobs that were actually submitted count, those already running
+    // for the day view are skipped by the submit functions
+    u32 job_count = 0;
+    for (usize i = 0; i < ARRAY_LENGTH(days); ++i) {
+        for (int test = 1; test >= 0; --test) {
+            if (submit_day_jobs_both(i, (bool)test, 1, on_complete)) {
+                job_count += 2;
+                continue;
+            }
+            job_count += submit_day_job(i, 1, (bool)test, 1, on_complete);
+            job_count += submit_day_job(i, 2, (bool)test, 1, on_complete);
+        }
+    }
+    atomic_store_u32(&run_all.job_count, job_count);
+    run_all_finish_if_done();
+}
+
+static const char *
+run_all_status(void)
+{
+    static char status[128];
+    if (!run_all.started) return NULL;
+
+    u32 completed_count = atomic_load_u32(&run_all.completed_count);
+    if (completed_count < run_all.job_count) {
+        snprintf(status, sizeof(status), "Running %u/%u", completed_count, run_all.job_count);
+    } else {
+        u64 wall_ns = atomic_load_u64(&run_all.end_ns) - run_all.begin_ns;
+        u64 cpu_ns  = atomic_load_u64(&run_all.cpu_ns);
+        snprintf(status, sizeof(status), "Wall %.2f ms | CPU %.2f ms (%.1fx)",
+                 (f64)wall_ns / 1e6, (f64)cpu_ns / 1e6, wall_ns ? (f64)cpu_ns / (f64)wall_ns : 0.0);
+    }
+    return status;
+}
+
+// Waits until every job started by run_all_problems is done, or cancels
+// those still running once timeout_seconds have passed. Returns false if
+// anything had to be cancelled.
+#define RUN_ALL_POLL_NS 1000000ull
+
+static bool
+run_all_wait(f64 timeout_seconds)
+{
+    u64 deadline_ns = run_all.begin_ns + (u64)(timeout_seconds * (f64)NANOS_PER_SECOND);
+    while (atomic_load_u32(&run_all.completed_count) < run_all.job_count) {
+        if (time_now_ns() >= deadline_ns) {
+            for (usize i = 0; i < ARRAY_LENGTH(days); ++i) {
+                for (u32 part = 1; part <= 2; ++part) {
+                    run_job_cancel(day_job(i, part, true));
+                    run_job_cancel(day_job(i, part, false));
+                }
+            }
+            return false;
+        }
+        sleep_ns(RUN_ALL_POLL_NS);
+    }
+    return true;
+}
+
+static void
+handle_run_all_button_interaction(Clay_ElementId   element_id,
+                                  Clay_PointerData pointer_info,
+                                  intptr_t         user_data)
+{
+    UNUSED(element_id);
+    UNUSED(user_data);
+    if (pointer_info.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        run_all_problems(handle_run_all_job_complete);
+    }
+}
+
+static void
+handle_run_button_interaction(Clay_ElementId   element_id,
+                              Clay_PointerData pointer_info,
+                              intptr_t         user_data)
+{
+    UNUSED(element_id);
+    bool test = (bool)user_data;
+    if (pointer_info.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        run_active_problem(test, 1);
+    }
+}
+
+static void
+handle_repeat_button_interaction(Clay_ElementId   element_id,
+                                 Clay_PointerData pointer_info,
+                                 intptr_t         user_data)
+{
+    UNUSED(element_id);
+    bool test = (bool)user_data;
+    if (pointer_info.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        run_active_problem(test, RUN_REPEAT_COUNT);
+    }
+}
+
+static void
+handle_cancel_button_interaction(Clay_ElementId   element_id,
+                                 Clay_PointerData pointer_info,
+                                 intptr_t         user_data)
+{
+    UNUSED(element_id);
+    if (pointer_info.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        run_job_cancel((RunJob *)user_data);
+    }
+}
+
+// Progress bars move in steps of 1/PROGRESS_STEPS, so a running job only
+// causes a redraw when its bar visibly changes
+#define PROGRESS_STEPS     200
+#define PROGRESS_BAR_WIDTH 360
+
+// 0 if the job is not running or has not reported progress, otherwise 1 + the step
+static u32
+run_job_progress_step(RunJob *job)
+{
+    if (run_job_state(job) != RUN_JOB_RUNNING) return 0;
+    f32 progress = run_job_progress(job);
+    if (progress < 0) return 0;
+    return 1 + (u32)(progress * PROGRESS_STEPS);
+}
+
+static void
+RunJobText(RunJob *job)
+{
+    RunJobState state = run_job_state(job);
+    if (state == RUN_JOB_RUNNING) {
+        CLAY({.layout = {.childGap = 20, .childAlignment = {.y = CLAY_ALIGN_Y_CENTER}}}) {
+            CLAY_TEXT(CLAY_STRING("Running..."), CLAY_TEXT_CONFIG({.fontSize = 24,
+                                                                   .textColor = SECONDARY_TEXT_COLOR}));
+            CLAY({.backgroundColor = Clay_Hovered() ? SECONDARY_ACCENT_COLOR : SURFACE_COLOR,
+                  .layout = {.padding = {20,20,5,5}}})
+            {
+                Clay_OnHover(handle_cancel_button_interaction, (intptr_t)job);
+                CLAY_TEXT(CLAY_STRING("Cancel"), CLAY_TEXT_CONFIG({.fontSize = 20,
+                                                                   .textColor = Clay_Hovered() ? ACCENT_TEXT_COLOR : PRIMARY_TEXT_COLOR}));
+            }
+        }
+        u32 step = run_job_progress_step(job);
+        if (step > 0) {
+            f32 progress = (f32)(step - 1) / (f32)PROGRESS_STEPS;
+            CLAY({.layout = {.sizing = {.width = CLAY_SIZING_FIXED(PROGRESS_BAR_WIDTH), .height = CLAY_SIZING_FIXED(8)}},
+                  .backgroundColor = SURFACE_COLOR})
+            {
+                CLAY({.layout = {.sizing = {.width = CLAY_SIZING_PERCENT(progress), .height = CLAY_SIZING_GROW()}},
+                      .backgroundColor = PRIMARY_ACCENT_COLOR}) {}
+            }
+        }
+        return;
+    }
+    if (state != RUN_JOB_DONE) return;
+
+    if (job->result.cancelled) {
+        CLAY_TEXT(CLAY_STRING("Cancelled"), CLAY_TEXT_CONFIG({.fontSize = 24,
+                                                              .textColor = SECONDARY_TEXT_COLOR}));
+    } else if (job->result.answer) {
+        Clay_String answer = {.chars = job->result.answer,
+                              .length = (s32)strlen(job->result.answer)};
+        CLAY_TEXT(answer, CLAY_TEXT_CONFIG({.fontSize = 24,
+                                            .textColor = PRIMARY_TEXT_COLOR,
+                                            .textAlignment = CLAY_TEXT_ALIGN_CENTER}));
+    } else {
+        return;
+    }
+    Clay_String summary = {.chars = job->result.summary,
+                           .length = (s32)strlen(job->result.summary)};
+    CLAY_TEXT(summary, CLAY_TEXT_CONFIG({.fontSize = 16,
+                                         .textColor = SECONDARY_TEXT_COLOR}));
+    if (job->result.allocation_summary[0]) {
+        Clay_String allocations = {.chars = job->result.allocation_summary,
+                                   .length = (s32)strlen(job->result.allocation_summary)};
+        CLAY_TEXT(allocations, CLAY_TEXT_CONFIG({.fontSize = 16,
+                                                 .textColor = SECONDARY_TEXT_COLOR}));
+    }
+}
+
+
+
+// Input viewer. Only the lines inside the visible part of MainContent are
+// emitted, so measuring and drawing cost is bounded by the viewport and not
+// by the size of the input. Everything above and below is a fixed height spacer.
+#define VIEWER_FONT_SIZE         16
+#define VIEWER_LINE_HEIGHT       20
+#define VIEWER_MAX_LINE_CHARS    96  // Longer lines are cut off at the width of the panel
+#define VIEWER_MAX_VISIBLE_LINES 256
+#define VIEWER_OVERSCAN_LINES    4   // Covers the frame of lag in the element positions
+#define LINE_INDEX_STRIDE        64  // Every 64th line start is stored, the rest are found by scanning
+
+typedef struct {
+    const char *text;
+    usize       length;
+    usize       line_count;
+    usize      *checkpoints; // Offset of every LINE_INDEX_STRIDE'th line
+} LineIndex;
+
+static void
+line_index_free(LineIndex *index)
+{
+    free(index->checkpoints);
+    *index = (LineIndex){0};
+}
+
+static void
+line_index_build(LineIndex *index, const char *text, usize length)
+{
+    line_index_free(index);
+    index->text   = text;
+    index->length = length;
+
+    usize checkpoint_capacity = 16;
+    index->checkpoints = (usize *)malloc(checkpoint_capacity * sizeof(usize));
+
+    usize offset = 0;
+    while (offset < length) {
+        if (index->line_count % LINE_INDEX_STRIDE == 0) {
+            usize checkpoint = index->line_count / LINE_INDEX_STRIDE;
+            if (checkpoint == checkpoint_capacity) {
+                checkpoint_capacity *= 2;
+                index->checkpoints = (usize *)realloc(index->checkpoints, checkpoint_capacity * sizeof(usize));
+            }
+            index->checkpoints[checkpoint] = offset;
+        }
+        index->line_count += 1;
+
+        const char *newline = memchr(text + offset, '\n', length - offset);
+        offset = newline ? (usize)(newline - text) + 1 : length;
+    }
+}
+
+static usize
+line_index_line_start(LineIndex *index, usize line)
+{
+    usize offset = index->checkpoints[line / LINE_INDEX_STRIDE];
+    for (usize i = 0; i < line % LINE_INDEX_STRIDE; ++i) {
+        const char *newline = memchr(index->text + offset, '\n', index->length - offset);
+        offset = (usize)(newline - index->text) + 1;
+    }
+    return offset;
+}
+
+static struct {
+    bool      open;
+    bool      test;
+    LineIndex index;
+    f32       top_in_content;  // Position in MainContent when unscrolled
+    f32       layout_scroll_y; // Scroll position the last layout was done with
+} input_viewer;
+
+static void layout_mark_dirty(void);
+
+static void
+handle_input_viewer_button_interaction(Clay_ElementId   element_id,
+                                       Clay_PointerData pointer_info,
+                                       intptr_t         user_data)
+{
+    UNUSED(element_id);
+    bool test = (bool)user_data;
+    if (pointer_info.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        input_viewer.open = !(input_viewer.open && input_viewer.test == test);
+        input_viewer.test = test;
+    }
+}
+
+static void
+InputViewerButton(Clay_String label, bool test)
+{
+    bool active = input_viewer.open && input_viewer.test == test;
+    CLAY({.backgroundColor = Clay_Hovered() ? SECONDARY_ACCENT_COLOR : (active ? PRIMARY_ACCENT_COLOR : SURFACE_HIGHLIGHT_COLOR),
+          .layout = {.padding = {20,20,10,10}}})
+    {
+        Clay_OnHover(handle_input_viewer_button_interaction, (intptr_t)test);
+        CLAY_TEXT(label, CLAY_TEXT_CONFIG({.fontSize = 24,
+                                           .textColor = (Clay_Hovered() || active) ? ACCENT_TEXT_COLOR : PRIMARY_TEXT_COLOR}));
+    }
+}
+
+static void
+InputViewer(usize day_index, u32 part)
+{
+    CLAY({.id = CLAY_ID("InputViewerButtons"),
+          .layout = {.childGap = 10,
+                     .childAlignment = {.y = CLAY_ALIGN_Y_CENTER}}})
+    {
+        InputViewerButton(CLAY_STRING("Test input"), true);
+        InputViewerButton(CLAY_STRING("Real input"), false);
+
+        if (input_viewer.open) {
+            static char info[64];
+            snprintf(info, sizeof(info), "%llu lines | %.1f KiB",
+                     (unsigned long long)input_viewer.index.line_count, (f64)input_viewer.index.length / 1024.0);
+            Clay_String info_text = {.chars = info, .length = (s32)strlen(info)};
+            CLAY_TEXT(info_text, CLAY_TEXT_CONFIG({.fontSize = 16,
+                                                   .textColor = SECONDARY_TEXT_COLOR}));
+        }
+    }
+    if (!input_viewer.open) return;
+
+    Clay_String input = day_input(day_index, part, input_viewer.test);
+    if (input_viewer.index.text != input.chars) {
+        line_index_build(&input_viewer.index, input.chars, (usize)input.length);
+    }
+    LineIndex *index = &input_viewer.index;
+
+    // Visible range in viewer coordinates, from the current scroll position
+    // and where the viewer sat in the content at the last layout. When that
+    // moved, the range is off for this layout, so another one is requested.
+    usize first_line   = 0;
+    usize end_line     = VIEWER_MAX_VISIBLE_LINES;
+    Clay_ElementData         viewer_data  = Clay_GetElementData(Clay_GetElementId(CLAY_STRING("InputViewer")));
+    Clay_ElementData         content_data = Clay_GetElementData(Clay_GetElementId(CLAY_STRING("MainContent")));
+    Clay_ScrollContainerData scroll_data  = Clay_GetScrollContainerData(Clay_GetElementId(CLAY_STRING("MainContent")));
+    if (viewer_data.found && content_data.found && scroll_data.found) {
+        f32 top_in_content = viewer_data.boundingBox.y - content_data.boundingBox.y - input_viewer.layout_scroll_y;
+        if (fabsf(top_in_content - input_viewer.top_in_content) > 0.5f) {
+            input_viewer.top_in_content = top_in_content;
+            layout_mark_dirty();
+        }
+
+        f32 top    = -scroll_data.scrollPosition->y - input_viewer.top_in_content;
+        f32 bottom = top + content_data.boundingBox.height;
+        s64 first  = (s64)(top / VIEWER_LINE_HEIGHT) - VIEWER_OVERSCAN_LINES;
+        s64 end    = (s64)(bottom / VIEWER_LINE_HEIGHT) + 1 + VIEWER_OVERSCAN_LINES;
+        first_line = (usize)max_s64(first, 0);
+        end_line   = (usize)max_s64(end, 0);
+    }
+    if (scroll_data.found) input_viewer.layout_scroll_y = scroll_data.scrollPosition->y;
+    if (end_line > index->line_count)                      end_line   = index->line_count;
+    if (first_line > end_line)                             first_line = end_line;
+    if (end_line - first_line > VIEWER_MAX_VISIBLE_LINES)  end_line   = first_line + VIEWER_MAX_VISIBLE_LINES;
+
+    CLAY({.id = CLAY_ID("InputViewer"),
+          .layout = {.layoutDirection = CLAY_TOP_TO_BOTTOM,
+                     .padding = {20,20,0,0},
+                     .sizing = {.width = CLAY_SIZING_GROW(), .height = CLAY_SIZING_FIXED((f32)index->line_count * VIEWER_LINE_HEIGHT)}},
+          .backgroundColor = SURFACE_HIGHLIGHT_COLOR})
+    {
+        CLAY({.layout = {.sizing = {.height = CLAY_SIZING_FIXED((f32)first_line * VIEWER_LINE_HEIGHT)}}}) {}
+
+        usize offset = (first_line < end_line) ? line_index_line_start(index, first_line) : 0;
+        for (usize line = first_line; line < end_line; ++line) {
+            const char *newline    = memchr(index->text + offset, '\n', index->length - offset);
+            usize       line_end   = newline ? (usize)(newline - index->text) : index->length;
+            usize       line_chars = line_end - offset;
+            if (line_chars > 0 && index->text[offset + line_chars - 1] == '\r') line_chars -= 1;
+            if (line_chars > VIEWER_MAX_LINE_CHARS)                          line_chars  = VIEWER_MAX_LINE_CHARS;
+
+            CLAY({.layout = {.sizing = {.height = CLAY_SIZING_FIXED(VIEWER_LINE_HEIGHT)}}})
+            {
+                Clay_String line_text = {.chars = index->text + offset, .length = (s32)line_chars};
+                CLAY_TEXT(line_text, CLAY_TEXT_CONFIG({.fontId = FONT_ID_MONO_16,
+                                                       .fontSize = VIEWER_FONT_SIZE,
+                                                       .lineHeight = VIEWER_LINE_HEIGHT,
+                                                       .wrapMode = CLAY_TEXT_WRAP_NONE,
+                                                       .textColor = PRIMARY_TEXT_COLOR}));
+            }
+            offset = line_end + 1;
+        }
+    }
+}
+
+// Grid visualizer. Day 4 part 2 runs on a private copy of an input and
+// publishes the grid after every round into triple buffered GridFrames. The
+// newest frame is uploaded to a grayscale texture whenever a frame is drawn,
+// and a custom element draws the texture as a single quad, so the number of
+// cells costs neither layout nor draw calls. Zoom with the wheel and pan by
+// dragging, both only change what the renderer reads and need no new layout.
+#define GRID_VISUALIZER_GENERATED_SIZE 2048
+#define GRID_VISUALIZER_GENERATED_FILL 70   // Percentage of generated cells with a roll of paper
+#define GRID_VISUALIZER_VIEW_WIDTH     1000 // Width of DayOuter
+#define GRID_VISUALIZER_VIEW_HEIGHT    600
+#define GRID_VISUALIZER_ZOOM_STEP      1.25f
+#define GRID_VISUALIZER_MIN_ZOOM       (1.0f / 64.0f)
+#define GRID_VISUALIZER_MAX_ZOOM       64.0f
+
+typedef enum {
+    GRID_SOURCE_TEST,
+    GRID_SOURCE_REAL,
+    GRID_SOURCE_GENERATED,
+} GridSource;
+
+static struct {
+    bool                open;
+    GridSource          source;
+    char               *input; // Private, so no other job on the same input publishes
+    usize               input_length;
+    GridFrames          frames;
+    RunJob              job;
+    Texture2D           texture;
+    u32                 round;
+    CustomLayoutElement element;
+    bool                panning;
+    Vector2             pan_mouse_origin;
+    Vector2             pan_center_origin;
+} grid_visualizer;
+
+static GridFrames *
+grid_visualizer_frames(void)
+{
+    return &grid_visualizer.frames;
+}
+
+static RunJob *
+grid_visualizer_job(void)
+{
+    return &grid_visualizer.job;
+}
+
+// Random grid in the puzzle's format, the same every time
+static char *
+generate_grid(u32 size, usize *length)
+{
+    usize pitch = (usize)size + 1;
+    char *grid  = (char *)malloc(pitch * size + 1);
+    u64   state = 0x9E3779B97F4A7C15ull;
+    for (u32 y = 0; y < size; ++y) {
+        for (u32 x = 0; x < size; ++x) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            grid[y*pitch + x] = (state % 100 < GRID_VISUALIZER_GENERATED_FILL) ? '@' : '.';
+        }
+        grid[y*pitch + size] = '\n';
+    }
+    grid[pitch * size] = '\0';
+    *length = pitch * size;
+    return grid;
+}
+
+static void
+grid_visualizer_start(usize day_index, GridSource source)
+{
+    // The input and frames belong to the running job until it is done
+    if (run_job_state(&grid_visualizer.job) == RUN_JOB_RUNNING) return;
+
+    free(grid_visualizer.input);
+    if (source == GRID_SOURCE_GENERATED) {
+        grid_visualizer.input = generate_grid(GRID_VISUALIZER_GENERATED_SIZE, &grid_visualizer.input_length);
+    } else {
+        Clay_String input = day_input(day_index, 2, source == GRID_SOURCE_TEST);
+        grid_visualizer.input_length = (usize)input.length;
+        grid_visualizer.input = (char *)malloc(grid_visualizer.input_length + 1);
+        memcpy(grid_visualizer.input, input.chars, grid_visualizer.input_length + 1);
+    }
+
+    const char *newline = memchr(grid_visualizer.input, '\n', grid_visualizer.input_length);
+    u32 width  = newline ? (u32)(newline - grid_visualizer.input) : 0;
+    u32 height = width ? (u32)((grid_visualizer.input_length + 1) / (width + 1)) : 0;
+    if (width == 0 || height == 0) return;
+    grid_frames_init(&grid_visualizer.frames, grid_visualizer.input, width, height);
+
+    if (grid_visualizer.texture.width != (int)width || grid_visualizer.texture.height != (int)height) {
+        if (grid_visualizer.texture.id) UnloadTexture(grid_visualizer.texture);
+        Image image = {.data    = grid_visualizer.frames.cells[0],
+                       .width   = (int)width,
+                       .height  = (int)height,
+                       .mipmaps = 1,
+                       .format  = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE};
+        grid_visualizer.texture = LoadTextureFromImage(image);
+    } else {
+        UpdateTexture(grid_visualizer.texture, grid_visualizer.frames.cells[0]);
+    }
+
+    f32 fit_zoom = fminf((f32)GRID_VISUALIZER_VIEW_WIDTH / (f32)width, (f32)GRID_VISUALIZER_VIEW_HEIGHT / (f32)height);
+    grid_visualizer.element = (CustomLayoutElement){
+        .type = CUSTOM_LAYOUT_ELEMENT_TYPE_TEXTURE_VIEW,
+        .customData.textureView = {.texture = &grid_visualizer.texture,
+                                   .center  = {(f32)width / 2.0f, (f32)height / 2.0f},
+                                   .zoom    = fit_zoom,
+                                   .tint    = {255, 214, 107, 255}}};
+    grid_visualizer.round  = 0;
+    grid_visualizer.source = source;
+    grid_visualizer.open   = true;
+
+    run_job_submit(thread_pool, &grid_visualizer.job, NULL, day_func(day_index, 2),
+                   grid_visualizer.input, grid_visualizer.input_length, 1, NULL);
+}
+
+// Called before the frame is laid out. Zooming and panning take the wheel and
+// the left button away from Clay, or MainContent would scroll along.
+static void
+grid_visualizer_handle_input(Vector2 mouse_position, f32 *wheel_y)
+{
+    CustomLayoutElement_TextureView *view = &grid_visualizer.element.customData.textureView;
+    if (!grid_visualizer.open || !view->texture) {
+        grid_visualizer.panning = false;
+        return;
+    }
+
+    Clay_ElementData view_data = Clay_GetElementData(Clay_GetElementId(CLAY_STRING("GridView")));
+    bool hovered = view_data.found && Clay_PointerOver(Clay_GetElementId(CLAY_STRING("GridView")));
+
+    if (hovered && *wheel_y != 0) {
+        // Keep the cell under the mouse in place
+        Vector2 offset = {mouse_position.x - (view_data.boundingBox.x + view_data.boundingBox.width / 2),
+                          mouse_position.y - (view_data.boundingBox.y + view_data.boundingBox.height / 2)};
+        f32 zoom = view->zoom * ((*wheel_y > 0) ? GRID_VISUALIZER_ZOOM_STEP : 1.0f / GRID_VISUALIZER_ZOOM_STEP);
+        zoom = fminf(fmaxf(zoom, GRID_VISUALIZER_MIN_ZOOM), GRID_VISUALIZER_MAX_ZOOM);
+        view->center.x += offset.x / view->zoom - offset.x / zoom;
+        view->center.y += offset.y / view->zoom - offset.y / zoom;
+        view->zoom = zoom;
+        *wheel_y = 0;
+    }
+
+    if (hovered && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+        grid_visualizer.panning           = true;
+        grid_visualizer.pan_mouse_origin  = mouse_position;
+        grid_visualizer.pan_center_origin = view->center;
+    }
+    if (!IsMouseButtonDown(MOUSE_BUTTON_LEFT)) grid_visualizer.panning = false;
+    if (grid_visualizer.panning) {
+        view->center.x = grid_visualizer.pan_center_origin.x - (mouse_position.x - grid_visualizer.pan_mouse_origin.x) / view->zoom;
+        view->center.y = grid_visualizer.pan_center_origin.y - (mouse_position.y - grid_visualizer.pan_mouse_origin.y) / view->zoom;
+    }
+}
+
+// Called before the frame is drawn
+static void
+grid_visualizer_upload(void)
+{
+    if (!grid_visualizer.texture.id || !grid_frames_acquire(&grid_visualizer.frames)) return;
+    TRACE_BEGIN("grid_visualizer_upload");
+    UpdateTexture(grid_visualizer.texture, grid_frames_read_buffer(&grid_visualizer.frames));
+    grid_visualizer.round = grid_frames_read_round(&grid_visualizer.frames);
+    TRACE_END("grid_visualizer_upload");
+}
+
+static void
+grid_visualizer_free(void)
+{
+    if (grid_visualizer.texture.id) UnloadTexture(grid_visualizer.texture);
+    grid_frames_free(&grid_visualizer.frames);
+    free(grid_visualizer.input);
+    run_result_free(&grid_visualizer.job.result);
+}
+
+static void
+handle_grid_visualizer_button_interaction(Clay_ElementId   element_id,
+                                          Clay_PointerData pointer_info,
+                                          intptr_t         user_data)
+{
+    UNUSED(element_id);
+    GridSource source = (GridSource)user_data;
+    if (pointer_info.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
+        grid_visualizer_start(active_day_index, source);
+    }
+}
+
+static void
+GridVisualizerButton(Clay_String label, GridSource source)
+{
+    bool active = grid_visualizer.open && grid_visualizer.source == source;
+    CLAY({.backgroundColor = Clay_Hovered() ? SECONDARY_ACCENT_COLOR : (active ? PRIMARY_ACCENT_COLOR : SURFACE_HIGHLIGHT_COLOR),
+          .layout = {.padding = {20,20,10,10}}})
+    {
+        Clay_OnHover(handle_grid_visualizer_button_interaction, (intptr_t)source);
+        CLAY_TEXT(label, CLAY_TEXT_CONFIG({.fontSize = 24,
+                                           .textColor = (Clay_Hovered() || active) ? ACCENT_TEXT_COLOR : PRIMARY_TEXT_COLOR}));
+    }
+}
+
+static void
+GridVisualizer(void)
+{
+    CLAY({.id = CLAY_ID("GridVisualizerButtons"),
+          .layout = {.childGap = 10,
+                     .childAlignment = {.y = CLAY_ALIGN_Y_CENTER}}})
+    {
+        GridVisualizerButton(CLAY_STRING("Watch test"), GRID_SOURCE_TEST);
+        GridVisualizerButton(CLAY_STRING("Watch real"), GRID_SOURCE_REAL);
+        GridVisualizerButton(CLAY_STRING("Watch 2048x2048"), GRID_SOURCE_GENERATED);
+
+        if (grid_visualizer.open) {
+            static char info[96];
+            RunJob *job = &grid_visualizer.job;
+            snprintf(info, sizeof(info), "Round %u | %ux%u cells%s%s", grid_visualizer.round,
+                     grid_visualizer.frames.width, grid_visualizer.frames.height,
+                     (run_job_state(job) == RUN_JOB_DONE && job->result.answer) ? " | removed " : "",
+                     (run_job_state(job) == RUN_JOB_DONE && job->result.answer) ? job->result.answer : "");
+            Clay_String info_text = {.chars = info, .length = (s32)strlen(info)};
+            CLAY_TEXT(info_text, CLAY_TEXT_CONFIG({.fontSize = 16,
+                                                   .textColor = SECONDARY_TEXT_COLOR}));
+        }
+    }
+    if (!grid_visualizer.open) return;
+
+    CLAY({.id = CLAY_ID("GridView"),
+          .layout = {.sizing = {.width = CLAY_SIZING_GROW(), .height = CLAY_SIZING_FIXED(GRID_VISUALIZER_VIEW_HEIGHT)}},
+          .backgroundColor = BG_COLOR,
+          .custom = {.customData = &grid_visualizer.element}}) {}
+}
+
+// Startup. The window opens before the icon and fonts are ready and shows
+// placeholders in raylib's default font. Both are embedded, the font atlases
+// already rasterized by bs, so the thread pool only decodes and unpacks them,
+// and the main loop uploads each one to the GPU, which only it may do, as
+// soon as it is ready.
+
+typedef struct {
+    const char  *path;
+    int          size;
+    Font         font;  // Everything but the texture
+    Image        atlas;
+    volatile u32 loaded;
+    bool         uploaded;
+} StartupFont;
+
+static Font fonts[3];
+
+static struct {
+    u64          begin_ns;
+    u64          first_frame_ns; // Time to first frame, 0 until it is drawn
+    u64          ready_ns;       // Time until everything is loaded and uploaded
+    StartupFont  fonts[ARRAY_LENGTH(fonts)];
+    Image        icon;
+    volatile u32 icon_loaded;
+    bool         icon_uploaded;
+    volatile u32 loaded_count;   // Finished tasks, so the idle main loop notices them
+    void       (*volatile wakeup)(void);
+} startup = {
+    .fonts = {
+        [0] = {.path = "data/Roboto-Regular.ttf",    .size = 48}, // FONT_ID_BODY_24
+        [1] = {.path = "data/Roboto-Regular.ttf",    .size = 32}, // FONT_ID_BODY_16
+        [2] = {.path = "data/RobotoMono-Medium.ttf", .size = 32}, // FONT_ID_MONO_16
+    },
+};
+
+static void
+startup_task_done(void)
+{
+    atomic_fetch_add_u32(&startup.loaded_count, 1);
+    void (*wakeup)(void) = startup.wakeup;
+    if (wakeup) wakeup();
+}
+
+static void
+load_icon_task(void *user_data)
+{
+    UNUSED(user_data);
+    TRACE_BEGIN("load_icon");
+    const EmbeddedFile *file = embedded_file("data/aoc_icon.png");
+    if (file) startup.icon = LoadImageFromMemory(".png", file->data, (int)file->size);
+    atomic_store_u32(&startup.icon_loaded, 1);
+    TRACE_END("load_icon");
+    startup_task_done();
+}
+
+// Turns a baked font into what LoadFontEx(path, size, 0, 400) returns, minus
+// the texture and the per glyph images nothing here draws with
+static void
+load_font_task(void *user_data)
+{
+    StartupFont *startup_font = (StartupFont *)user_data;
+    TRACE_BEGIN("load_font");
+    const EmbeddedFont *baked = embedded_font(startup_font->path, startup_font->size);
+    if (baked) {
+        Font font = {.baseSize     = baked->size,
+                     .glyphCount   = baked->glyph_count,
+                     .glyphPadding = baked->padding,
+                     .glyphs       = (GlyphInfo *)calloc(baked->glyph_count, sizeof(GlyphInfo)),
+                     .recs         = (Rectangle *)calloc(baked->glyph_count, sizeof(Rectangle))};
+        for (int i = 0; i < baked->glyph_count; ++i) {
+            const EmbeddedGlyph *glyph = &baked->glyphs[i];
+            font.glyphs[i] = (GlyphInfo){.value    = glyph->value,
+                                         .offsetX  = glyph->offset_x,
+                                         .offsetY  = glyph->offset_y,
+                                         .advanceX = glyph->advance_x};
+            font.recs[i]   = (Rectangle){glyph->x, glyph->y, glyph->width, glyph->height};
+        }
+
+        // Coverage becomes the alpha of white pixels, as in GenImageFontAtlas
+        usize pixel_count = (usize)baked->atlas_width * (usize)baked->atlas_height;
+        u8   *pixels      = (u8 *)malloc(pixel_count*2);
+        for (usize i = 0; i < pixel_count; ++i) {
+            pixels[2*i]     = 255;
+            pixels[2*i + 1] = baked->atlas[i];
+        }
+        startup_font->atlas = (Image){.data    = pixels,
+                                      .width   = baked->atlas_width,
+                                      .height  = baked->atlas_height,
+                                      .mipmaps = 1,
+                                      .format  = PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA};
+        startup_font->font  = font;
+    }
+    atomic_store_u32(&startup_font->loaded, 1);
+    TRACE_END("load_font");
+    startup_task_done();
+}
+
+static void
+startup_begin_loading(void)
+{
+    thread_pool_submit(thread_pool, load_icon_task, NULL);
+    for (usize i = 0; i < ARRAY_LENGTH(startup.fonts); ++i) {
+        thread_pool_submit(thread_pool, load_font_task, &startup.fonts[i]);
+    }
+}
+
+// Called every iteration of the main loop, before deciding whether to draw
+static void
+startup_poll(void)
+{
+    if (startup.ready_ns) return;
+
+    bool ready = true;
+    for (usize i = 0; i < ARRAY_LENGTH(startup.fonts); ++i) {
+        StartupFont *startup_font = &startup.fonts[i];
+        if (startup_font->uploaded) continue;
+        if (!atomic_load_u32(&startup_font->loaded)) {
+            ready = false;
+            continue;
+        }
+        if (startup_font->font.glyphs) {
+            TRACE_BEGIN("upload_font");
+            startup_font->font.texture = LoadTextureFromImage(startup_font->atlas);
+            SetTextureFilter(startup_font->font.texture, TEXTURE_FILTER_BILINEAR);
+            UnloadImage(startup_font->atlas);
+            fonts[i] = startup_font->font;
+            TRACE_END("upload_font");
+            // Words measured with the placeholder font would keep their size
+            Clay_ResetMeasureTextCache();
+            layout_mark_dirty();
+        } else {
+            fprintf(stderr, "Font \"%s\" at %d was not embedded\n", startup_font->path, startup_font->size);
+        }
+        startup_font->uploaded = true;
+    }
+
+    if (!startup.icon_uploaded) {
+        if (atomic_load_u32(&startup.icon_loaded)) {
+            aoc_icon = LoadTextureFromImage(startup.icon);
+            UnloadImage(startup.icon);
+            startup.icon_uploaded = true;
+        } else {
+            ready = false;
+        }
+    }
 
-struct {
-    const char *day_button_title;
+    if (ready) {
+        startup.ready_ns = time_now_ns() - startup.begin_ns;
+        printf("Startup: first frame after %.1f ms, everything loaded after %.1f ms\n",
+               (f64)startup.first_frame_ns / 1e6, (f64)startup.ready_ns / 1e6);
+    }
+}
 
-    const char *title_file;
-    Clay_String title;
+static void
+startup_frame_drawn(void)
+{
+    if (startup.first_frame_ns) return;
+    startup.first_frame_ns = time_now_ns() - startup.begin_ns;
+    TRACE_END("time_to_first_frame");
+}
 
-    ProblemFunc  part1_func;
-    const char  *part1_description_file;
-    Clay_String  part1_description;
-    const char  *part1_test_data_file;
-    Clay_String  part1_test_data;
-    const char  *part1_real_data_file;
-    Clay_String  part1_real_data;
-    char        *part1_test_result;
-    char        *part1_real_result;
+static const char *
+startup_status(void)
+{
+    static char status[64];
+    if (startup.ready_ns) {
+        snprintf(status, sizeof(status), "First frame %.1f ms | ready %.1f ms",
+                 (f64)startup.first_frame_ns / 1e6, (f64)startup.ready_ns / 1e6);
+    } else {
+        snprintf(status, sizeof(status), "First frame %.1f ms | loading...", (f64)startup.first_frame_ns / 1e6);
+    }
+    return status;
+}
 
-    ProblemFunc  part2_func;
-    const char  *part2_description_file;
-    Clay_String  part2_description;
-    const char  *part2_test_data_file;
-    Clay_String  part2_test_data;
-    const char  *part2_real_data_file;
-    Clay_String  part2_real_data;
-    char        *part2_test_result;
-    char        *part2_real_result;
+// Idle redraw. A frame is only drawn when something it depends on has
+// changed, otherwise the main loop sleeps until input arrives, a job
+// finishes, or IDLE_WAIT_SECONDS pass. Progress does not wake it up, so
+// while a job runs it looks again every PROGRESS_WAIT_SECONDS.
+#define IDLE_WAIT_SECONDS     0.5
+#define PROGRESS_WAIT_SECONDS 0.05
+// Frames drawn after the last change, so state changed by click handlers
+// during layout makes it to the screen
+#define SETTLE_FRAME_COUNT 2
 
-} days[] = {
-    { .day_button_title       = "Day 1",
-      .title_file             = "data/day1/title.txt",
-      .part1_description_file = "data/day1/part1_description.txt",
-      .part1_test_data_file   = "data/day1/test_data.txt",
-      .part1_real_data_file   = "data/day1/real_data.txt",
-      .part1_func             = day1_part1,
-      .part2_description_file = "data/day1/part2_description.txt",
-      .part2_test_data_file   = "data/day1/test_data.txt",
-      .part2_real_data_file   = "data/day1/real_data.txt",
-      .part2_func             = day1_part2},
+// All fields are 4 bytes, so there is no padding and snapshots compare with memcmp
+typedef struct {
+    f32 mouse_x, mouse_y;
+    f32 wheel_x, wheel_y;
+    u32 mouse_buttons;
+    u32 key_pressed;
+    u32 screen_width, screen_height;
+    u32 focused;
+    u32 close_requested;
+    f32 days_scroll_x, days_scroll_y;
+    f32 main_scroll_x, main_scroll_y;
+    u32 job_states[ARRAY_LENGTH(days)][4];
+    u32 job_progress_steps[ARRAY_LENGTH(days)][4];
+    u32 grid_published_count;
+    u32 startup_loaded_count;
+} FrameInputs;
 
-    { .day_button_title       = "Day 2",
-      .title_file             = "data/day2/title.txt",
-      .part1_description_file = "data/day2/part1_description.txt",
-      .part1_test_data_file   = "data/day2/test_data.txt",
-      .part1_real_data_file   = "data/day2/real_data.txt",
-      .part1_func             = day2_part1,
-      .part2_description_file = "data/day2/part2_description.txt",
-      .part2_test_data_file   = "data/day2/test_data.txt",
-      .part2_real_data_file   = "data/day2/real_data.txt",
-      .part2_func             = day2_part2},
+static struct {
+    FrameInputs previous_inputs;
+    u32         settle_frames;
+    u64         drawn_count;
+    u64         skipped_count;
+} redraw = {.settle_frames = SETTLE_FRAME_COUNT};
 
-    { .day_button_title       = "Day 3",
-      .title_file             = "data/day3/title.txt",
-      .part1_description_file = "data/day3/part1_description.txt",
-      .part1_test_data_file   = "data/day3/test_data.txt",
-      .part1_real_data_file   = "data/day3/real_data.txt",
-      .part1_func             = day3_part1,
-      .part2_description_file = "data/day3/part2_description.txt",
-      .part2_test_data_file   = "data/day3/test_data.txt",
-      .part2_real_data_file   = "data/day3/real_data.txt",
-      .part2_func             = day3_part2},
+static void
+get_scroll_position(Clay_String id, f32 *x, f32 *y)
+{
+    Clay_ScrollContainerData scroll_container_data = Clay_GetScrollContainerData(Clay__HashString(id, 0, 0));
+    if (!scroll_container_data.found) return;
+    *x = scroll_container_data.scrollPosition->x;
+    *y = scroll_container_data.scrollPosition->y;
+}
 
-    { .day_button_title       = "Day 4",
-      .title_file             = "data/day4/title.txt",
-      .part1_description_file = "data/day4/part1_description.txt",
-      .part1_test_data_file   = "data/day4/test_data.txt",
-      .part1_real_data_file   = "data/day4/real_data.txt",
-      .part1_func             = day4_part1,
-      .part2_description_file = "data/day4/part2_description.txt",
-      .part2_test_data_file   = "data/day4/test_data.txt",
-      .part2_real_data_file   = "data/day4/real_data.txt",
-      .part2_func             = day4_part2},
+static void
+capture_frame_inputs(FrameInputs *inputs)
+{
+    memset(inputs, 0, sizeof(*inputs));
 
-    { .day_button_title       = "Day 5",
-      .title_file             = "data/day5/title.txt",
-      .part1_description_file = "data/day5/part1_description.txt",
-      .part1_test_data_file   = "data/day5/test_data.txt",
-      .part1_real_data_file   = "data/day5/real_data.txt",
-      .part1_func             = day5_part1,
-      .part2_description_file = "data/day5/part2_description.txt",
-      .part2_test_data_file   = "data/day5/test_data.txt",
-      .part2_real_data_file   = "data/day5/real_data.txt",
-      .part2_func             = day5_part2},
-};
+    Vector2 mouse_position    = GetMousePosition();
+    Vector2 mouse_wheel_delta = GetMouseWheelMoveV();
+    inputs->mouse_x = mouse_position.x;
+    inputs->mouse_y = mouse_position.y;
+    inputs->wheel_x = mouse_wheel_delta.x;
+    inputs->wheel_y = mouse_wheel_delta.y;
+    for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_MIDDLE; ++button) {
+        if (IsMouseButtonDown(button)) inputs->mouse_buttons |= 1u << button;
+    }
+    inputs->key_pressed     = (u32)GetKeyPressed();
+    inputs->screen_width    = (u32)GetScreenWidth();
+    inputs->screen_height   = (u32)GetScreenHeight();
+    inputs->focused         = IsWindowFocused();
+    // raylib only picks this up when polling input at the end of a frame
+    inputs->close_requested = (u32)glfwWindowShouldClose(glfwGetCurrentContext());
 
+    // Differs between frames while scrolling has momentum
+    get_scroll_position(CLAY_STRING("DaysContainer"), &inputs->days_scroll_x, &inputs->days_scroll_y);
+    get_scroll_position(CLAY_STRING("MainContent"),   &inputs->main_scroll_x, &inputs->main_scroll_y);
 
+    for (usize i = 0; i < ARRAY_LENGTH(days); ++i) {
+        for (u32 part = 1; part <= 2; ++part) {
+            inputs->job_states[i][(part - 1)*2 + 0] = run_job_state(day_job(i, part, false));
+            inputs->job_states[i][(part - 1)*2 + 1] = run_job_state(day_job(i, part, true));
+            inputs->job_progress_steps[i][(part - 1)*2 + 0] = run_job_progress_step(day_job(i, part, false));
+            inputs->job_progress_steps[i][(part - 1)*2 + 1] = run_job_progress_step(day_job(i, part, true));
+        }
+    }
+    inputs->grid_published_count = atomic_load_u32(&grid_visualizer.frames.published_count);
+    inputs->startup_loaded_count = atomic_load_u32(&startup.loaded_count);
+}
 
-const uint32_t FONT_ID_BODY_24 = 0;
-const uint32_t FONT_ID_BODY_16 = 1;
-#define COLOR_ORANGE (Clay_Color){225, 138, 50, 255}
-#define COLOR_BLUE   (Clay_Color){111, 173, 162, 255}
+static bool
+frame_needs_redraw(void)
+{
+    FrameInputs inputs;
+    capture_frame_inputs(&inputs);
+    if (memcmp(&inputs, &redraw.previous_inputs, sizeof(inputs)) != 0) {
+        redraw.settle_frames = SETTLE_FRAME_COUNT;
+    }
+    redraw.previous_inputs = inputs;
 
-// COLORS
-#define BG_COLOR                (Clay_Color){13, 17, 22, 255}
-#define SURFACE_COLOR           (Clay_Color){22, 27, 34, 255}
-#define SURFACE_HIGHLIGHT_COLOR (Clay_Color){30, 36, 45, 255}
+    if (redraw.settle_frames == 0) return false;
+    redraw.settle_frames -= 1;
+    return true;
+}
 
-#define PRIMARY_ACCENT_COLOR (Clay_Color){74, 179, 244, 255}
-#define SECONDARY_ACCENT_COLOR (Clay_Color){107, 214, 255, 255}
+// Input callbacks update raylib's state while waiting, which the next drawn
+// frame sees as if it had been polled at the end of the previous one
+static void
+wait_for_events(void)
+{
+    bool job_running = false;
+    for (usize i = 0; i < ARRAY_LENGTH(days); ++i) {
+        for (u32 part = 1; part <= 2; ++part) {
+            if (run_job_state(day_job(i, part, false)) == RUN_JOB_RUNNING) job_running = true;
+            if (run_job_state(day_job(i, part, true))  == RUN_JOB_RUNNING) job_running = true;
+        }
+    }
+    glfwWaitEventsTimeout(job_running ? PROGRESS_WAIT_SECONDS : IDLE_WAIT_SECONDS);
+}
 
-#define PRIMARY_TEXT_COLOR (Clay_Color){229, 233, 240, 255}
-#define SECONDARY_TEXT_COLOR (Clay_Color){169, 180, 198, 255}
-#define ACCENT_TEXT_COLOR (Clay_Color){10, 14, 18, 255}
+// Called on a worker when a job finishes, to wake up wait_for_events
+static void
+wake_main_loop(void)
+{
+    glfwPostEmptyEvent();
+}
 
-Texture2D aoc_icon;
+static const char *
+redraw_status(void)
+{
+    static char status[64];
+    snprintf(status, sizeof(status), "Frames drawn %llu\nFrames skipped %llu",
+             (unsigned long long)redraw.drawn_count, (unsigned long long)redraw.skipped_count);
+    return status;
+}
 
-#define RAYLIB_VECTOR2_TO_CLAY_VECTOR2(vector) (Clay_Vector2){.x = vector.x, .y = vector.y}
+// Text that changes every frame would make every frame build a new layout.
+// The layout only has an empty element of its size, and the text is drawn on
+// top of it after the retained render commands.
+#define FRAME_TEXT_FONT_SIZE 16
 
-Clay_TextElementConfig headerTextConfig = {.fontId = 1, .letterSpacing = 5, .fontSize = 16, .textColor = {0,0,0,255}};
+static void
+frame_text_placeholder(Clay_String id, u32 line_count)
+{
+    u32 height = line_count * FRAME_TEXT_FONT_SIZE + (line_count - 1) * 2; // raylib's default text line spacing
+    CLAY({.id = CLAY_SID(id),
+          .layout = {.sizing = {.width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_FIXED((f32)height)}}}) {}
+}
 
-static usize active_day_index    = 0;
-static u32   active_problem_part = 1;
+static void
+draw_frame_text(Clay_String id, const char *text)
+{
+    Clay_ElementData data = Clay_GetElementData(Clay_GetElementId(id));
+    if (!data.found) return;
+    Font font = (fonts[0].texture.id != 0) ? fonts[0] : GetFontDefault();
+    Vector2 position = {roundf(data.boundingBox.x), roundf(data.boundingBox.y)};
+    DrawTextEx(font, text, position, FRAME_TEXT_FONT_SIZE, 0, CLAY_COLOR_TO_RAYLIB_COLOR(SECONDARY_TEXT_COLOR));
+}
+
+// Retained layout. CreateLayout only runs when the layout key changes, the
+// render commands of the previous run are reused otherwise. Anything the
+// layout reads must either be hashed into the key in layout_key_inputs, or
+// call layout_mark_dirty when it changes.
+static struct {
+    Clay_RenderCommandArray render_commands;
+    bool                    valid;
+    volatile u32            dirty;
+    u64                     key;
+    u64                     pending_key;
+    u64                     built_count;
+    u64                     reused_count;
+    u64                     build_ns;
+} retained_layout;
 
 static void
-handle_day_button_interaction(Clay_ElementId   element_id,
-                              Clay_PointerData pointer_info,
-                              intptr_t         user_data)
+layout_mark_dirty(void)
 {
-    UNUSED(element_id);
-    usize index = (usize)user_data;
-    if (pointer_info.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
-        if (index <= ARRAY_LENGTH(days)) {
-            active_day_index = index;
-            active_problem_part = 1;
-        }
-    }
+    atomic_store_u32(&retained_layout.dirty, 1);
 }
 
 static void
-handle_part_button_interaction(Clay_ElementId   element_id,
-                               Clay_PointerData pointer_info,
-                               intptr_t         user_data)
+layout_key_add(const void *data, usize size)
 {
-    UNUSED(element_id);
-    u32 part = (u32)user_data;
-    if (pointer_info.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
-        if (part == 1) active_problem_part = 1;
-        else           active_problem_part = 2;
-    }
+    retained_layout.pending_key = hash_bytes(data, size, retained_layout.pending_key);
 }
 
 static void
-handle_run_button_interaction(Clay_ElementId   element_id,
-                              Clay_PointerData pointer_info,
-                              intptr_t         user_data)
+layout_key_add_scroll_position(Clay_String id)
 {
-    UNUSED(element_id);
-    bool test = (bool)user_data;
-    if (pointer_info.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME) {
-        if (test) {
-            if (active_problem_part == 1) {
-                free(days[active_day_index].part1_test_result);
-                days[active_day_index].part1_test_result = days[active_day_index].part1_func(days[active_day_index].part1_test_data.chars, days[active_day_index].part1_test_data.length);
-            } else {
-                free(days[active_day_index].part2_test_result);
-                days[active_day_index].part2_test_result = days[active_day_index].part2_func(days[active_day_index].part2_test_data.chars, days[active_day_index].part2_test_data.length);
-            }
-        } else {
-            if (active_problem_part == 1) {
-                free(days[active_day_index].part1_real_result);
-                days[active_day_index].part1_real_result = days[active_day_index].part1_func(days[active_day_index].part1_real_data.chars, days[active_day_index].part1_real_data.length);
-            } else {
-                free(days[active_day_index].part2_real_result);
-                days[active_day_index].part2_real_result = days[active_day_index].part2_func(days[active_day_index].part2_real_data.chars, days[active_day_index].part2_real_data.length);
-            }
+    f32 position[2] = {0};
+    get_scroll_position(id, &position[0], &position[1]);
+    layout_key_add(position, sizeof(position));
+}
+
+static void
+layout_key_inputs(void)
+{
+    layout_key_add(&active_day_index,    sizeof(active_day_index));
+    layout_key_add(&active_problem_part, sizeof(active_problem_part));
+
+    // Clay_Hovered() in the layout depends on what the pointer is over, not
+    // on where exactly it is
+    Clay_ElementIdArray pointer_over_ids = Clay_GetPointerOverIds();
+    for (s32 i = 0; i < pointer_over_ids.length; ++i) {
+        layout_key_add(&pointer_over_ids.internalArray[i].id, sizeof(pointer_over_ids.internalArray[i].id));
+    }
+
+    layout_key_add_scroll_position(CLAY_STRING("DaysContainer"));
+    layout_key_add_scroll_position(CLAY_STRING("MainContent"));
+
+    s32 dimensions[2] = {GetScreenWidth(), GetScreenHeight()};
+    layout_key_add(dimensions, sizeof(dimensions));
+
+    for (usize i = 0; i < ARRAY_LENGTH(days); ++i) {
+        for (u32 part = 1; part <= 2; ++part) {
+            u32 states[4] = {run_job_state(day_job(i, part, false)),         run_job_state(day_job(i, part, true)),
+                             run_job_progress_step(day_job(i, part, false)), run_job_progress_step(day_job(i, part, true))};
+            layout_key_add(states, sizeof(states));
         }
     }
+
+    u32 run_all_progress[2] = {run_all.started, atomic_load_u32(&run_all.completed_count)};
+    layout_key_add(run_all_progress, sizeof(run_all_progress));
+
+    bool viewer_state[2] = {input_viewer.open, input_viewer.test};
+    layout_key_add(viewer_state, sizeof(viewer_state));
+
+    u32 grid_visualizer_state[4] = {grid_visualizer.open, grid_visualizer.source, grid_visualizer.round,
+                                    run_job_state(&grid_visualizer.job)};
+    layout_key_add(grid_visualizer_state, sizeof(grid_visualizer_state));
+
+    u64 startup_state[2] = {startup.first_frame_ns, startup.ready_ns};
+    layout_key_add(startup_state, sizeof(startup_state));
+}
+
+// Scrolling is applied by Clay_UpdateScrollContainers, which forgets scroll
+// containers that were not declared since its last call, so wheel input and
+// held buttons always rebuild the layout along with it. Panning the grid
+// visualizer keeps the button from Clay, so it does not count.
+static bool
+layout_needs_rebuild(Clay_Vector2 scroll_delta)
+{
+    retained_layout.pending_key = 0;
+    layout_key_inputs();
+
+    bool rebuild = !retained_layout.valid
+                || retained_layout.pending_key != retained_layout.key
+                || atomic_load_u32(&retained_layout.dirty)
+                || scroll_delta.x != 0 || scroll_delta.y != 0
+                || (IsMouseButtonDown(MOUSE_BUTTON_LEFT) && !grid_visualizer.panning)
+                || Clay_IsDebugModeEnabled();
+    return rebuild;
 }
 
+static const char *
+layout_status(void)
+{
+    static char status[96];
+    u64 frame_count = retained_layout.built_count + retained_layout.reused_count;
+    f64 build_ms    = retained_layout.built_count ? (f64)retained_layout.build_ns / (f64)retained_layout.built_count / 1e6 : 0.0;
+    f64 saved_ms    = frame_count ? build_ms * (f64)retained_layout.reused_count / (f64)frame_count : 0.0;
+    snprintf(status, sizeof(status), "Layout %.3f ms\nReused %llu/%llu\nSaves %.3f ms/frame",
+             build_ms, (unsigned long long)retained_layout.reused_count, (unsigned long long)frame_count, saved_ms);
+    return status;
+}
+
+
 static Clay_RenderCommandArray
 CreateLayout(void)
 {
@@ -227,6 +1613,27 @@ CreateLayout(void)
                     }
                 }
             }
+            CLAY({.id = CLAY_ID("RunAllButton"),
+                  .layout = {.padding = {40,40,20,20},
+                             .sizing = {.width = CLAY_SIZING_GROW()}},
+                  .backgroundColor = Clay_Hovered() ? SECONDARY_ACCENT_COLOR : PRIMARY_ACCENT_COLOR})
+            {
+                Clay_OnHover(handle_run_all_button_interaction, 0);
+                CLAY_TEXT(CLAY_STRING("Run all"), CLAY_TEXT_CONFIG({.fontSize = 24,
+                                                                   .textColor = ACCENT_TEXT_COLOR}));
+            }
+            const char *status = run_all_status();
+            if (status) {
+                Clay_String status_text = {.chars = status, .length = (s32)strlen(status)};
+                CLAY_TEXT(status_text, CLAY_TEXT_CONFIG({.fontSize = 16,
+                                                         .textColor = SECONDARY_TEXT_COLOR}));
+            }
+            frame_text_placeholder(CLAY_STRING("FrameStatus"), 2);
+            const char *startup_stats = startup_status();
+            Clay_String startup_status_text = {.chars = startup_stats, .length = (s32)strlen(startup_stats)};
+            CLAY_TEXT(startup_status_text, CLAY_TEXT_CONFIG({.fontSize = 16,
+                                                             .textColor = SECONDARY_TEXT_COLOR}));
+            frame_text_placeholder(CLAY_STRING("LayoutStatus"), 3);
         }
 
         CLAY({.id = CLAY_ID("RightPanel"),
@@ -310,32 +1717,34 @@ CreateLayout(void)
                                          .sizing = {.width = CLAY_SIZING_FIXED(400)},
                                          .childGap = 10}})
                         {
-                            CLAY({.id = CLAY_ID("RunTestButtonWrapper"),
-                                  .backgroundColor = Clay_Hovered() ? SECONDARY_ACCENT_COLOR : PRIMARY_ACCENT_COLOR,
-                                  .layout = {.padding = {50,50,10,10}}})
+                            CLAY({.id = CLAY_ID("RunTestButtons"),
+                                  .layout = {.childGap = 10}})
                             {
-                                Clay_OnHover(handle_run_button_interaction, (intptr_t)true);
-                                CLAY_TEXT(CLAY_STRING("Run test"), CLAY_TEXT_CONFIG({.fontSize = 28,
-                                                                                     .textColor = ACCENT_TEXT_COLOR}));
+                                CLAY({.id = CLAY_ID("RunTestButtonWrapper"),
+                                      .backgroundColor = Clay_Hovered() ? SECONDARY_ACCENT_COLOR : PRIMARY_ACCENT_COLOR,
+                                      .layout = {.padding = {50,50,10,10}}})
+                                {
+                                    Clay_OnHover(handle_run_button_interaction, (intptr_t)true);
+                                    CLAY_TEXT(CLAY_STRING("Run test"), CLAY_TEXT_CONFIG({.fontSize = 28,
+                                                                                         .textColor = ACCENT_TEXT_COLOR}));
+                                }
+                                CLAY({.id = CLAY_ID("RepeatTestButtonWrapper"),
+                                      .backgroundColor = Clay_Hovered() ? SECONDARY_ACCENT_COLOR : SURFACE_HIGHLIGHT_COLOR,
+                                      .layout = {.padding = {20,20,10,10}}})
+                                {
+                                    Clay_OnHover(handle_repeat_button_interaction, (intptr_t)true);
+                                    CLAY_TEXT(CLAY_STRING(RUN_REPEAT_LABEL), CLAY_TEXT_CONFIG({.fontSize = 28,
+                                                                                           .textColor = Clay_Hovered() ? ACCENT_TEXT_COLOR : PRIMARY_TEXT_COLOR}));
+                                }
                             }
                             CLAY({.id = CLAY_ID("RunTestResultWrapper"),
-                                  .layout = {.padding = {20,0,10,10},
-                                  .sizing = {.width = CLAY_SIZING_GROW(), .height = CLAY_SIZING_GROW(200)}},
+                                  .layout = {.layoutDirection = CLAY_TOP_TO_BOTTOM,
+                                             .padding = {20,0,10,10},
+                                             .childGap = 10,
+                                             .sizing = {.width = CLAY_SIZING_GROW(), .height = CLAY_SIZING_GROW(200)}},
                                   .backgroundColor = SURFACE_HIGHLIGHT_COLOR})
                             {
-                                char *result_cstr = NULL;
-                                if (active_problem_part == 1) {
-                                    result_cstr = days[i].part1_test_result;
-                                } else {
-                                    result_cstr = days[i].part2_test_result;
-                                }
-                                if (result_cstr) {
-                                    Clay_String result = {.chars = result_cstr,
-                                                          .length = (s32)strlen(result_cstr)};
-                                    CLAY_TEXT(result, CLAY_TEXT_CONFIG({.fontSize = 24,
-                                                                        .textColor = PRIMARY_TEXT_COLOR,
-                                                                        .textAlignment = CLAY_TEXT_ALIGN_CENTER}));
-                                }
+                                RunJobText(day_job(i, active_problem_part, true));
                             }
                         }
                         CLAY({.id = CLAY_ID("RunRealWrapper"),
@@ -343,35 +1752,39 @@ CreateLayout(void)
                                          .sizing = {.width = CLAY_SIZING_FIXED(400)},
                                          .childGap = 10}})
                         {
-                            CLAY({.id = CLAY_ID("RunRealButtonWrapper"),
-                                  .backgroundColor = Clay_Hovered() ? SECONDARY_ACCENT_COLOR : PRIMARY_ACCENT_COLOR,
-                                  .layout = {.padding = {50,50,10,10}}})
+                            CLAY({.id = CLAY_ID("RunRealButtons"),
+                                  .layout = {.childGap = 10}})
                             {
-                                Clay_OnHover(handle_run_button_interaction, (intptr_t)false);
-                                CLAY_TEXT(CLAY_STRING("Run real"), CLAY_TEXT_CONFIG({.fontSize = 28,
-                                                                                     .textColor = ACCENT_TEXT_COLOR}));
+                                CLAY({.id = CLAY_ID("RunRealButtonWrapper"),
+                                      .backgroundColor = Clay_Hovered() ? SECONDARY_ACCENT_COLOR : PRIMARY_ACCENT_COLOR,
+                                      .layout = {.padding = {50,50,10,10}}})
+                                {
+                                    Clay_OnHover(handle_run_button_interaction, (intptr_t)false);
+                                    CLAY_TEXT(CLAY_STRING("Run real"), CLAY_TEXT_CONFIG({.fontSize = 28,
+                                                                                         .textColor = ACCENT_TEXT_COLOR}));
+                                }
+                                CLAY({.id = CLAY_ID("RepeatRealButtonWrapper"),
+                                      .backgroundColor = Clay_Hovered() ? SECONDARY_ACCENT_COLOR : SURFACE_HIGHLIGHT_COLOR,
+                                      .layout = {.padding = {20,20,10,10}}})
+                                {
+                                    Clay_OnHover(handle_repeat_button_interaction, (intptr_t)false);
+                                    CLAY_TEXT(CLAY_STRING(RUN_REPEAT_LABEL), CLAY_TEXT_CONFIG({.fontSize = 28,
+                                                                                           .textColor = Clay_Hovered() ? ACCENT_TEXT_COLOR : PRIMARY_TEXT_COLOR}));
+                                }
                             }
                             CLAY({.id = CLAY_ID("RunRealResultWrapper"),
-                                  .layout = {.padding = {20,0,10,10},
+                                  .layout = {.layoutDirection = CLAY_TOP_TO_BOTTOM,
+                                             .padding = {20,0,10,10},
+                                             .childGap = 10,
                                              .sizing = {.width = CLAY_SIZING_GROW(), .height = CLAY_SIZING_GROW(200)}},
                                   .backgroundColor = SURFACE_HIGHLIGHT_COLOR})
                             {
-                                char *result_cstr = NULL;
-                                if (active_problem_part == 1) {
-                                    result_cstr = days[i].part1_real_result;
-                                } else {
-                                    result_cstr = days[i].part2_real_result;
-                                }
-                                if (result_cstr) {
-                                    Clay_String result = {.chars = result_cstr,
-                                                          .length = (s32)strlen(result_cstr)};
-                                    CLAY_TEXT(result, CLAY_TEXT_CONFIG({.fontSize = 24,
-                                                                        .textColor = PRIMARY_TEXT_COLOR,
-                                                                        .textAlignment = CLAY_TEXT_ALIGN_CENTER}));
-                                }
+                                RunJobText(day_job(i, active_problem_part, false));
                             }
                         }
                     }
+                    InputViewer(i, active_problem_part);
+                    if (days[i].part2_grid_visualizer && active_problem_part == 2) GridVisualizer();
                 }
             }
         }
@@ -421,14 +1834,16 @@ update_draw_frame(Font* fonts)
     }
 #endif
 
+    grid_visualizer_handle_input(GetMousePosition(), &mouse_wheel_y);
+
     Clay_Vector2 mouse_position = RAYLIB_VECTOR2_TO_CLAY_VECTOR2(GetMousePosition());
-    Clay_SetPointerState(mouse_position, IsMouseButtonDown(0) && !scrollbar_data.mouse_down);
+    Clay_SetPointerState(mouse_position, IsMouseButtonDown(0) && !scrollbar_data.mouse_down && !grid_visualizer.panning);
     Clay_SetLayoutDimensions((Clay_Dimensions) { (float)GetScreenWidth(), (float)GetScreenHeight() });
     if (!IsMouseButtonDown(0)) {
         scrollbar_data.mouse_down = false;
     }
 
-    if (IsMouseButtonDown(0) && !scrollbar_data.mouse_down && Clay_PointerOver(Clay__HashString(CLAY_STRING("ScrollBar"), 0, 0))) {
+    if (IsMouseButtonDown(0) && !scrollbar_data.mouse_down && !grid_visualizer.panning && Clay_PointerOver(Clay__HashString(CLAY_STRING("ScrollBar"), 0, 0))) {
         Clay_ScrollContainerData scroll_container_data = Clay_GetScrollContainerData(Clay__HashString(CLAY_STRING("MainContent"), 0, 0));
         scrollbar_data.click_origin                    = mouse_position;
         scrollbar_data.position_origin                 = *scroll_container_data.scrollPosition;
@@ -447,16 +1862,36 @@ update_draw_frame(Font* fonts)
         }
     }
 
-    Clay_UpdateScrollContainers(true, (Clay_Vector2) {mouse_wheel_x, mouse_wheel_y}, GetFrameTime());
-    Clay_RenderCommandArray render_commands = CreateLayout();
+    Clay_Vector2 scroll_delta = {mouse_wheel_x, mouse_wheel_y};
+    if (layout_needs_rebuild(scroll_delta)) {
+        Clay_UpdateScrollContainers(true, scroll_delta, GetFrameTime());
+        // Cleared first, so the layout itself can ask for another one
+        atomic_store_u32(&retained_layout.dirty, 0);
+        u64 build_begin_ns = time_now_ns();
+        TRACE_BEGIN("CreateLayout");
+        retained_layout.render_commands = CreateLayout();
+        TRACE_END("CreateLayout");
+        retained_layout.build_ns    += time_now_ns() - build_begin_ns;
+        retained_layout.built_count += 1;
+        retained_layout.key   = retained_layout.pending_key;
+        retained_layout.valid = true;
+    } else {
+        retained_layout.reused_count += 1;
+    }
+    grid_visualizer_upload();
     BeginDrawing();
     ClearBackground(BLACK);
-    Clay_Raylib_Render(render_commands, fonts);
+    TRACE_BEGIN("Clay_Raylib_Render");
+    Clay_Raylib_Render(retained_layout.render_commands, fonts);
+    draw_frame_text(CLAY_STRING("FrameStatus"), redraw_status());
+    draw_frame_text(CLAY_STRING("LayoutStatus"), layout_status());
+    TRACE_END("Clay_Raylib_Render");
+    TRACE_BEGIN("EndDrawing");
     EndDrawing();
+    TRACE_END("EndDrawing");
 }
 
 bool reinitialize_clay = false;
-static Font fonts[2];
 
 static void
 handle_clay_errors(Clay_ErrorData errorData)
@@ -472,27 +1907,213 @@ handle_clay_errors(Clay_ErrorData errorData)
 }
 
 
-int
-aoc2025_entry(void)
+static struct {
+    CapContext *ctx;
+
+    bool   all;
+    int    bench;
+    int    threads;
+    bool   pin_threads;
+    bool   result_cache;
+    double timeout;
+    Isa    isa;
+} cli;
+
+static void
+init_cli(int argc, char **argv)
+{
+    cli.ctx = cap_context_new();
+
+    cap_set_program_description(cli.ctx, "Advent of Code 2025 solutions");
+
+    cap_flag(cli.ctx, &cli.all)
+        ->long_name("all")
+        ->description("Solve every day, part and dataset on the thread pool, print the results and exit without opening a window.")
+        ->done();
+
+    cap_option_int(cli.ctx, &cli.bench)
+        ->long_name("bench")
+        ->description("Run every solver this many times in a row on its real input, and the grid days also on a large generated grid, print the minimum and median durations and exit without opening a window. Runs on one thread and never uses the result cache.")
+        ->default_value(0)
+        ->done();
+
+    cap_flag(cli.ctx, &cli.result_cache)
+        ->long_name("no-result-cache")
+        ->invert()
+        ->description("Always run the solvers, instead of returning answers cached in \""RESULT_CACHE_DIR"\" for unchanged inputs and solvers. Use this when benchmarking.")
+        ->done();
+
+    cap_option_double(cli.ctx, &cli.timeout)
+        ->long_name("timeout")
+        ->description("With --all, cancel the solvers still running after this many seconds and exit with an error. Values of 0 or less mean no limit.")
+        ->default_value(0.0)
+        ->done();
+
+    cap_option_enum(cli.ctx, Isa, &cli.isa)
+        ->long_name("isa")
+        ->description("Instruction set level of the solvers. 'auto' picks the highest one this cpu supports, the others are for comparing them.")
+        ->metavar("level")
+        ->entry(ISA_AUTO, "auto")
+        ->entry(ISA_BASELINE, "baseline")
+        ->entry(ISA_SSE42, "sse4.2")
+        ->entry(ISA_AVX2, "avx2")
+        ->entry(ISA_AVX512, "avx512")
+        ->default_value(ISA_AUTO)
+        ->done();
+
+    cap_option_int(cli.ctx, &cli.threads)
+        ->long_name("threads")
+        ->short_name('t')
+        ->description("Number of solver threads. Values of 0 or less mean one per cpu.")
+        ->default_value(0)
+        ->done();
+
+    cap_flag(cli.ctx, &cli.pin_threads)
+        ->long_name("pin-threads")
+        ->description("Keep every solver thread on a cpu of its own, so the scheduler never moves them around. Mostly useful for steadier benchmarks.")
+        ->done();
+
+    int exit_code;
+    if (cap_parse_and_handle(cli.ctx, argc, argv, &exit_code) == CAP_EXIT) {
+        cap_context_free(cli.ctx);
+        exit(exit_code);
+    }
+}
+
+static void
+print_day_job(RunJob *job)
+{
+    for (usize i = 0; i < ARRAY_LENGTH(days); ++i) {
+        for (u32 part = 1; part <= 2; ++part) {
+            for (int test = 1; test >= 0; --test) {
+                if (day_job(i, part, (bool)test) != job) continue;
+                // One printf per job, so lines from concurrent workers do not interleave
+                printf("%-6s part %u %-4s: %-20s (%s)\n%s%s%s", days[i].day_button_title, part, test ? "test" : "real",
+                       job->result.answer ? job->result.answer : "", job->result.summary,
+                       job->result.allocation_summary[0] ? "    " : "", job->result.allocation_summary,
+                       job->result.allocation_summary[0] ? "\n" : "");
+                return;
+            }
+        }
+    }
+}
+
+static void
+handle_cli_run_all_job_complete(RunJob *job)
+{
+    print_day_job(job);
+    handle_run_all_job_complete(job);
+}
+
+// Benchmarks, one whitespace separated line per solver and input so `bs --pgo`
+// can compare runs. The generated grid is much larger than the real inputs,
+// to cover the paths that only large grids take.
+#define BENCH_GENERATED_GRID_SIZE 512
+
+static void
+bench_solver(usize day_index, u32 part, const char *input_name, const char *input, usize input_length, u32 repeat_count)
+{
+    SolverContext context = {0};
+    RunResult     result  = {0};
+    run_solver_repeated(&result, &context, day_func(day_index, part), input, input_length, repeat_count);
+    printf("%-15s %-10s %6u %14llu %14llu\n", day_solver_name(day_index, part), input_name, result.repeat_count,
+           (unsigned long long)result.min_ns, (unsigned long long)result.median_ns);
+    // Indented, bs --pgo only reads the lines above
+    if (result.allocation_summary[0]) printf("    %s\n", result.allocation_summary);
+    fflush(stdout);
+    run_result_free(&result);
+}
+
+static void
+bench_solve_both(usize day_index, const char *input_name, const char *input, usize input_length, u32 repeat_count)
+{
+    SolverContext context = {0};
+    RunResult     part1   = {0};
+    RunResult     part2   = {0};
+    run_solver_both(&part1, &part2, &context, NULL, NULL, days[day_index].solve_both_func, input, input_length, repeat_count);
+    printf("%-15s %-10s %6u %14llu %14llu\n", days[day_index].solve_both_name, input_name, part1.repeat_count,
+           (unsigned long long)part1.min_ns, (unsigned long long)part1.median_ns);
+    if (part1.allocation_summary[0]) printf("    %s\n", part1.allocation_summary);
+    fflush(stdout);
+    run_result_free(&part1);
+    run_result_free(&part2);
+}
+
+static void
+run_benchmarks(u32 repeat_count)
 {
+    usize generated_length = 0;
+    char *generated        = generate_grid(BENCH_GENERATED_GRID_SIZE, &generated_length);
+
+    printf("%-15s %-10s %6s %14s %14s\n", "solver", "input", "runs", "min_ns", "median_ns");
     for (usize i = 0; i < ARRAY_LENGTH(days); ++i) {
-        char *title               = read_entire_file(days[i].title_file);
-        days[i].title             = (Clay_String){.chars = title, .length = (s32)strlen(title)};
-        char *part1_description   = read_entire_file(days[i].part1_description_file);
-        days[i].part1_description = (Clay_String){.chars = part1_description, .length = (s32)strlen(part1_description)};
-        char *part1_test_data     = read_entire_file(days[i].part1_test_data_file);
-        days[i].part1_test_data   = (Clay_String){.chars = part1_test_data, .length = (s32)strlen(part1_test_data)};
-        char *part1_real_data     = read_entire_file(days[i].part1_real_data_file);
-        days[i].part1_real_data   = (Clay_String){.chars = part1_real_data, .length = (s32)strlen(part1_real_data)};
-        char *part2_description   = read_entire_file(days[i].part2_description_file);
-        days[i].part2_description = (Clay_String){.chars = part2_description, .length = (s32)strlen(part2_description)};
-        char *part2_test_data     = read_entire_file(days[i].part2_test_data_file);
-        days[i].part2_test_data   = (Clay_String){.chars = part2_test_data, .length = (s32)strlen(part2_test_data)};
-        char *part2_real_data     = read_entire_file(days[i].part2_real_data_file);
-        days[i].part2_real_data   = (Clay_String){.chars = part2_real_data, .length = (s32)strlen(part2_real_data)};
+        for (u32 part = 1; part <= 2; ++part) {
+            Clay_String input = day_input(i, part, false);
+            bench_solver(i, part, "real", input.chars, (usize)input.length, repeat_count);
+            // Days with a grid visualizer take grids in both parts
+            if (days[i].part2_grid_visualizer) bench_solver(i, part, "generated", generated, generated_length, repeat_count);
+        }
+        if (days[i].solve_both_func) {
+            Clay_String input = day_input(i, 1, false);
+            bench_solve_both(i, "real", input.chars, (usize)input.length, repeat_count);
+            if (days[i].part2_grid_visualizer) bench_solve_both(i, "generated", generated, generated_length, repeat_count);
+        }
+    }
+
+    free(generated);
+}
+
+int
+aoc2025_entry(int argc, char **argv)
+{
+    TRACE_SET_THREAD_NAME("main");
+    TRACE_BEGIN("time_to_first_frame");
+    startup.begin_ns = time_now_ns();
+
+    init_cli(argc, argv);
+
+    thread_pool = thread_pool_create(cli.threads > 0 ? (u32)cli.threads : 0, cli.pin_threads);
+    if (cli.result_cache) result_cache_set_directory(RESULT_CACHE_DIR);
+
+    int exit_code = 0;
+#ifdef AOC2025_HOT_RELOAD
+    if (!load_solver_library()) {
+        exit_code = 1;
+        goto done;
+    }
+#endif
+
+    if (!solvers_set_isa(cli.isa)) {
+        fprintf(stderr, "This cpu does not support the %s solvers, it goes up to %s\n", isa_name(cli.isa), isa_name(cpu_isa()));
+        exit_code = 1;
+        goto done;
     }
 
+    load_day_data();
 
+    if (cli.bench > 0) {
+        run_benchmarks((u32)cli.bench);
+        goto done;
+    }
+
+    if (cli.all) {
+        run_all_problems(handle_cli_run_all_job_complete);
+        bool finished = cli.timeout <= 0 || run_all_wait(cli.timeout);
+        thread_pool_wait(thread_pool);
+        printf("\n%s\nThreads: %u\nISA: %s\n", run_all_status(), cli.threads > 0 ? (u32)cli.threads : cpu_count(),
+               isa_name(solvers_isa()));
+        if (!finished) {
+            fprintf(stderr, "Timed out after %.1f s, cancelled the solvers still running\n", cli.timeout);
+            exit_code = 1;
+        }
+        goto done;
+    }
+
+
+    // Loads while the window is being created
+    startup_begin_loading();
+
+    Clay_SetMaxMeasureTextCacheWordCount(MEASURE_TEXT_CACHE_WORD_COUNT);
     u64 total_memory_size = Clay_MinMemorySize();
     Clay_Arena clay_memory = Clay_CreateArenaWithCapacityAndMemory(total_memory_size, malloc(total_memory_size));
     Clay_Initialize(clay_memory,
@@ -500,14 +2121,16 @@ aoc2025_entry(void)
                     (Clay_ErrorHandler){handle_clay_errors, 0});
     Clay_Raylib_Initialize(1400, 800, "Advent of Code 2025",
                            FLAG_VSYNC_HINT | FLAG_WINDOW_RESIZABLE | FLAG_MSAA_4X_HINT);
-    aoc_icon = LoadTexture("data/aoc_icon.png");
     set_native_window_icon();
 
-    fonts[FONT_ID_BODY_24] = LoadFontEx("data/Roboto-Regular.ttf", 48, 0, 400);
-    SetTextureFilter(fonts[FONT_ID_BODY_24].texture, TEXTURE_FILTER_BILINEAR);
-    fonts[FONT_ID_BODY_16] = LoadFontEx("data/Roboto-Regular.ttf", 32, 0, 400);
-    SetTextureFilter(fonts[FONT_ID_BODY_16].texture, TEXTURE_FILTER_BILINEAR);
+    // Until the fonts are uploaded, text is measured and drawn with raylib's default font
     Clay_SetMeasureTextFunction(Raylib_MeasureText, fonts);
+    startup.wakeup = wake_main_loop;
+    run_job_set_wakeup(wake_main_loop);
+    grid_visualizer.frames.on_publish = wake_main_loop;
+#ifndef AOC2025_HOT_RELOAD
+    day4_set_grid_frames(grid_visualizer_frames());
+#endif
 
 
     // Main loop
@@ -518,27 +2141,56 @@ aoc2025_entry(void)
             clay_memory = Clay_CreateArenaWithCapacityAndMemory(total_memory_size, malloc(total_memory_size));
             Clay_Initialize(clay_memory, (Clay_Dimensions) { (float)GetScreenWidth(), (float)GetScreenHeight() }, (Clay_ErrorHandler) { handle_clay_errors, 0 });
             reinitialize_clay = false;
+            layout_mark_dirty();
         }
+#ifdef AOC2025_HOT_RELOAD
+        hot_reload_solvers();
+#endif
+        startup_poll();
+        if (!frame_needs_redraw()) {
+            redraw.skipped_count += 1;
+            TRACE_BEGIN("wait_for_events");
+            wait_for_events();
+            TRACE_END("wait_for_events");
+            continue;
+        }
+        redraw.drawn_count += 1;
+        TRACE_BEGIN("update_draw_frame");
         update_draw_frame(fonts);
+        TRACE_END("update_draw_frame");
+        startup_frame_drawn();
     }
+
+    // Closing the window stops whatever is still solving instead of waiting
+    // for it, and no wakeups may be in flight when the window goes away
+    cancel_solver_jobs();
+    run_job_set_wakeup(NULL);
+    startup.wakeup = NULL;
+    grid_visualizer.frames.on_publish = NULL;
+    thread_pool_wait(thread_pool);
+    grid_visualizer_free();
     Clay_Raylib_Close();
 
+done:
+    thread_pool_wait(thread_pool);
+    thread_pool_destroy(thread_pool);
+
+#ifdef AOC2025_HOT_RELOAD
+    unload_solver_library();
+#endif
+
+    TRACE_WRITE("trace.json");
+
 
 
     for (usize i = 0; i < ARRAY_LENGTH(days); ++i) {
-        free((char *)days[i].title.chars);
-        free((char *)days[i].part1_description.chars);
-        free((char *)days[i].part1_test_data.chars);
-        free((char *)days[i].part1_real_data.chars);
-        free(days[i].part1_test_result);
-        free(days[i].part1_real_result);
-        free((char *)days[i].part2_description.chars);
-        free((char *)days[i].part2_test_data.chars);
-        free((char *)days[i].part2_real_data.chars);
-        free(days[i].part2_test_result);
-        free(days[i].part2_real_result);
+        run_result_free(&days[i].part1_test_job.result);
+        run_result_free(&days[i].part1_real_job.result);
+        run_result_free(&days[i].part2_test_job.result);
+        run_result_free(&days[i].part2_real_job.result);    }
+    line_index_free(&input_viewer.index);
 
-    }
+    cap_context_free(cli.ctx);
 
-    return 0;
+    return exit_code;
 }
@@ -1,7 +1,13 @@
 #ifndef AOC2025_H
 #define AOC2025_H
 
-int aoc2025_entry(void);
+int aoc2025_entry(int argc, char **argv);
 void set_native_window_icon(void);
 
+// Shared library loading, used to hot reload the solvers
+extern const char *solver_library_path;
+void *library_load(const char *path);
+void *library_symbol(void *library, const char *name);
+void  library_unload(void *library);
+
 #endif
@@ -0,0 +1,335 @@
+// Headless front end for the solver library (`libaoc_solvers.a`). Runs
+// solvers on input files and prints their answers and timings, without
+// anything from raylib, GLFW or Clay, so it builds and runs on machines
+// without a display.
+
+#include "basic.h"
+#include "days.h"
+#include "runner.h"
+#include "containers_bench.h"
+#include "input_loader.h"
+
+#define CAP_IMPLEMENTATION
+#define CAPDEF static inline
+#include "cap.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define DAY_COUNT       5
+#define REAL_INPUT_PATH "data/day%u/real_data.txt"
+
+static struct {
+    CapContext *ctx;
+
+    const char *solver;
+    const char *input;
+    int         repeat_count;
+    int         threads;
+    int         bench_containers;
+    bool        io_uring;
+    Isa         isa;
+    char      **input_paths; // Batch mode inputs
+    size_t      input_path_count;
+} cli;
+
+// Solvers split their work up on this, see parallel_lines.h
+static ThreadPool *thread_pool;
+
+static void
+init_cli(int argc, char **argv)
+{
+    cli.ctx = cap_context_new();
+
+    cap_set_program_description(cli.ctx, "Advent of Code 2025 solvers, without a window. Run from the root of the source tree to use the inputs in data/.");
+
+    cap_option_string(cli.ctx, &cli.solver)
+        ->long_name("solver")
+        ->short_name('s')
+        ->description("Only run this solver, e.g. day4_part2, or day4_solve_both for both parts at once. Runs all of them if not given.")
+        ->metavar("name")
+        ->done();
+
+    cap_option_string(cli.ctx, &cli.input)
+        ->long_name("input")
+        ->short_name('i')
+        ->description("Input file for --solver, instead of its real input in data/.")
+        ->metavar("path")
+        ->done();
+
+    cap_option_int(cli.ctx, &cli.repeat_count)
+        ->long_name("bench")
+        ->short_name('b')
+        ->description("Run every solver this many times in a row and also print the minimum and median durations.")
+        ->default_value(1)
+        ->done();
+
+    cap_flag(cli.ctx, &cli.io_uring)
+        ->long_name("no-io-uring")
+        ->invert()
+        ->description("Read batch mode inputs with pread on the thread pool even where io_uring is available.")
+        ->done();
+
+    cap_variadic(cli.ctx, &cli.input_paths, &cli.input_path_count)
+        ->label("inputs")
+        ->description("Input files to run --solver on in batch mode. They are read in the background while the solver runs on the ones already read.")
+        ->done();
+
+    cap_option_int(cli.ctx, &cli.bench_containers)
+        ->long_name("bench-containers")
+        ->description("Time the solvers' vectors and hash map against stb_ds this many times each, print the minimum durations and exit.")
+        ->default_value(0)
+        ->done();
+
+    cap_option_int(cli.ctx, &cli.threads)
+        ->long_name("threads")
+        ->short_name('t')
+        ->description("Number of threads a solver may split its work across. Values of 0 or less mean one per cpu, 1 runs everything on the main thread.")
+        ->default_value(0)
+        ->done();
+
+    cap_option_enum(cli.ctx, Isa, &cli.isa)
+        ->long_name("isa")
+        ->description("Instruction set level of the solvers. 'auto' picks the highest one this cpu supports.")
+        ->metavar("level")
+        ->entry(ISA_AUTO, "auto")
+        ->entry(ISA_BASELINE, "baseline")
+        ->entry(ISA_SSE42, "sse4.2")
+        ->entry(ISA_AVX2, "avx2")
+        ->entry(ISA_AVX512, "avx512")
+        ->default_value(ISA_AUTO)
+        ->done();
+
+    int exit_code;
+    if (cap_parse_and_handle(cli.ctx, argc, argv, &exit_code) == CAP_EXIT) {
+        cap_context_free(cli.ctx);
+        exit(exit_code);
+    }
+
+    // The runners take it as a u32 and need at least one run for the median
+    if (cli.repeat_count < 1) {
+        fprintf(stderr, "--bench needs at least 1 run, got %d\n", cli.repeat_count);
+        cap_context_free(cli.ctx);
+        exit(1);
+    }
+}
+
+static void
+print_result(const char *solver_name, const RunResult *result)
+{
+    // The app shows repeat timings on a line of their own
+    const char *summary     = result->summary;
+    const char *repeat_line = strchr(summary, '\n');
+    if (repeat_line) {
+        printf("%-12s %-20s (%.*s | %s)\n", solver_name, result->answer ? result->answer : "",
+               (int)(repeat_line - summary), summary, repeat_line + 1);
+    } else {
+        printf("%-12s %-20s (%s)\n", solver_name, result->answer ? result->answer : "", summary);
+    }
+    if (result->allocation_summary[0]) printf("    %s\n", result->allocation_summary);
+    fflush(stdout);
+}
+
+// Solves both parts of a day with its SolveBothFunc, solver_name is
+// "dayN_solve_both". Returns false if there is none or the input could not
+// be read.
+static bool
+solve_both(const char *solver_name, const char *input_path)
+{
+    SolveBothFunc func = solver_find_both(solver_name);
+    if (!func) return false;
+
+    char *input = read_entire_file(input_path);
+    if (!input) {
+        fprintf(stderr, "Could not read \"%s\"\n", input_path);
+        return false;
+    }
+
+    u32  day = 0;
+    char part1_name[32];
+    char part2_name[32];
+    sscanf(solver_name, "day%u_", &day);
+    snprintf(part1_name, sizeof(part1_name), "day%u_part1", day);
+    snprintf(part2_name, sizeof(part2_name), "day%u_part2", day);
+
+    SolverContext context = {.pool = thread_pool};
+    RunResult     part1   = {0};
+    RunResult     part2   = {0};
+    run_solver_both(&part1, &part2, &context, part1_name, part2_name, func, input, strlen(input), (u32)cli.repeat_count);
+    print_result(part1_name, &part1);
+    print_result(part2_name, &part2);
+
+    run_result_free(&part1);
+    run_result_free(&part2);
+    free(input);
+    return true;
+}
+
+// Returns false if there is no such solver or its input could not be read
+static bool
+solve(const char *solver_name, const char *input_path)
+{
+    ProblemFunc func = solver_find(solver_name);
+    if (!func) {
+        if (solver_find_both(solver_name)) return solve_both(solver_name, input_path);
+        fprintf(stderr, "There is no solver called \"%s\"\n", solver_name);
+        return false;
+    }
+
+    char *input = read_entire_file(input_path);
+    if (!input) {
+        fprintf(stderr, "Could not read \"%s\"\n", input_path);
+        return false;
+    }
+
+    SolverContext context = {.pool = thread_pool};
+    RunResult     result  = {0};
+    if (cli.repeat_count > 1) run_solver_repeated(&result, &context, func, input, strlen(input), (u32)cli.repeat_count);
+    else                      run_solver(&result, &context, solver_name, func, input, strlen(input));
+    print_result(solver_name, &result);
+
+    run_result_free(&result);
+    free(input);
+    return true;
+}
+
+// Batch mode, one solver on many inputs
+typedef struct {
+    const char   *solver_name;
+    ProblemFunc   func;
+    SolveBothFunc both_func;
+    char          part1_name[32];
+    char          part2_name[32];
+    RunResult    *results; // Two per input with both_func
+    bool         *loaded;
+} Batch;
+
+static void
+solve_loaded_input(usize index, const char *path, const char *data, usize size, void *user_data)
+{
+    UNUSED(path);
+    Batch *batch = (Batch *)user_data;
+    if (!data) return;
+    batch->loaded[index] = true;
+
+    SolverContext context = {.pool = thread_pool};
+    if (batch->both_func) {
+        run_solver_both(&batch->results[2*index], &batch->results[2*index + 1], &context, batch->part1_name,
+                        batch->part2_name, batch->both_func, data, size, (u32)cli.repeat_count);
+    } else if (cli.repeat_count > 1) {
+        run_solver_repeated(&batch->results[index], &context, batch->func, data, size, (u32)cli.repeat_count);
+    } else {
+        run_solver(&batch->results[index], &context, batch->solver_name, batch->func, data, size);
+    }
+}
+
+// Returns false if there is no such solver or an input could not be read
+static bool
+solve_batch(const char *solver_name, char **paths, usize path_count)
+{
+    Batch batch = {.solver_name = solver_name, .func = solver_find(solver_name)};
+    if (!batch.func) {
+        batch.both_func = solver_find_both(solver_name);
+        if (!batch.both_func) {
+            fprintf(stderr, "There is no solver called \"%s\"\n", solver_name);
+            return false;
+        }
+        u32 day = 0;
+        sscanf(solver_name, "day%u_", &day);
+        snprintf(batch.part1_name, sizeof(batch.part1_name), "day%u_part1", day);
+        snprintf(batch.part2_name, sizeof(batch.part2_name), "day%u_part2", day);
+    }
+
+    usize results_per_input = batch.both_func ? 2 : 1;
+    batch.results = (RunResult *)calloc(path_count * results_per_input, sizeof(*batch.results));
+    batch.loaded  = (bool *)calloc(path_count, sizeof(*batch.loaded));
+
+    u64 begin_ns = time_now_ns();
+    InputLoaderBackend backend = load_inputs(thread_pool, (const char *const *)paths, path_count, cli.io_uring,
+                                             solve_loaded_input, &batch);
+    u64 wall_ns = time_now_ns() - begin_ns;
+
+    bool all_loaded = true;
+    for (usize i = 0; i < path_count; ++i) {
+        if (!batch.loaded[i]) {
+            fprintf(stderr, "Could not read \"%s\"\n", paths[i]);
+            all_loaded = false;
+            continue;
+        }
+        if (batch.both_func) {
+            char label[512];
+            snprintf(label, sizeof(label), "%s (part 1)", paths[i]);
+            print_result(label, &batch.results[2*i]);
+            snprintf(label, sizeof(label), "%s (part 2)", paths[i]);
+            print_result(label, &batch.results[2*i + 1]);
+        } else {
+            print_result(paths[i], &batch.results[i]);
+        }
+    }
+    printf("\n%zu inputs read with %s and solved in %.2f ms\n", path_count, input_loader_backend_name(backend),
+           (f64)wall_ns / 1e6);
+
+    for (usize i = 0; i < path_count * results_per_input; ++i) run_result_free(&batch.results[i]);
+    free(batch.results);
+    free(batch.loaded);
+    return all_loaded;
+}
+
+int
+main(int argc, char **argv)
+{
+    init_cli(argc, argv);
+
+    int exit_code = 0;
+    if (cli.bench_containers > 0) {
+        containers_bench((u32)cli.bench_containers);
+        goto done;
+    }
+    if (!solvers_set_isa(cli.isa)) {
+        fprintf(stderr, "This cpu does not support the %s solvers, it goes up to %s\n", isa_name(cli.isa), isa_name(cpu_isa()));
+        exit_code = 1;
+        goto done;
+    }
+    if ((cli.input || cli.input_path_count) && !cli.solver) {
+        fprintf(stderr, "--input and input files need a --solver to run on them\n");
+        exit_code = 1;
+        goto done;
+    }
+
+    if (cli.threads != 1) thread_pool = thread_pool_create(cli.threads > 0 ? (u32)cli.threads : 0, false);
+
+    if (cli.input_path_count) {
+        if (cli.input) fprintf(stderr, "Ignoring --input in batch mode\n");
+        if (!solve_batch(cli.solver, cli.input_paths, cli.input_path_count)) exit_code = 1;
+    } else if (cli.solver) {
+        // The solver is checked before its input is read, an unknown one ends up as day 0
+        u32  day = 0;
+        char input_path[64];
+        sscanf(cli.solver, "day%u_", &day);
+        snprintf(input_path, sizeof(input_path), REAL_INPUT_PATH, day);
+        if (!solve(cli.solver, cli.input ? cli.input : input_path)) exit_code = 1;
+    } else {
+        for (u32 day = 1; day <= DAY_COUNT; ++day) {
+            char input_path[64];
+            char both_name[32];
+            snprintf(input_path, sizeof(input_path), REAL_INPUT_PATH, day);
+            snprintf(both_name, sizeof(both_name), "day%u_solve_both", day);
+            // One pass for both parts where the day has one
+            if (solver_find_both(both_name)) {
+                if (!solve_both(both_name, input_path)) exit_code = 1;
+                continue;
+            }
+            for (u32 part = 1; part <= 2; ++part) {
+                char solver_name[32];
+                snprintf(solver_name, sizeof(solver_name), "day%u_part%u", day, part);
+                if (!solve(solver_name, input_path)) exit_code = 1;
+            }
+        }
+    }
+    printf("\nISA: %s\n", isa_name(solvers_isa()));
+
+done:
+    if (thread_pool) thread_pool_destroy(thread_pool);
+    cap_context_free(cli.ctx);
+    return exit_code;
+}
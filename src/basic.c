@@ -1,13 +1,34 @@
+#ifndef _MSC_VER
+#define _GNU_SOURCE // pthread_setaffinity_np
+#endif
+
 #include "basic.h"
+#include "trace.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <cpuid.h>
+#endif
 
 char *
 read_entire_file(const char *path)
 {
     FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
     fseek(f, 0, SEEK_END);
     long fsize = ftell(f);
     fseek(f, 0, SEEK_SET);
@@ -20,6 +41,88 @@ read_entire_file(const char *path)
     return result;
 }
 
+bool
+write_entire_file(const char *path, const void *data, usize size)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    usize written = fwrite(data, 1, size, f);
+    bool ok = (written == size);
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+static bool
+create_directory(const char *path)
+{
+#ifdef _MSC_VER
+    if (CreateDirectoryA(path, NULL)) return true;
+    return GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+    if (mkdir(path, 0755) == 0) return true;
+    return errno == EEXIST;
+#endif
+}
+
+bool
+create_directories(const char *path)
+{
+    usize length = strlen(path);
+    char *buffer = (char *)malloc(length + 1);
+    memcpy(buffer, path, length + 1);
+
+    bool ok = true;
+    for (usize i = 1; i <= length && ok; ++i) {
+        if (buffer[i] != '/' && buffer[i] != '\\' && buffer[i] != '\0') continue;
+        char separator = buffer[i];
+        buffer[i] = '\0';
+        ok = create_directory(buffer);
+        buffer[i] = separator;
+    }
+
+    free(buffer);
+    return ok;
+}
+
+bool
+copy_file(const char *from_path, const char *to_path)
+{
+    FILE *from = fopen(from_path, "rb");
+    if (!from) return false;
+    FILE *to = fopen(to_path, "wb");
+    if (!to) {
+        fclose(from);
+        return false;
+    }
+
+    bool ok = true;
+    char buffer[64*1024];
+    usize read;
+    while (ok && (read = fread(buffer, 1, sizeof(buffer), from)) > 0) {
+        ok = fwrite(buffer, 1, read, to) == read;
+    }
+    if (ferror(from)) ok = false;
+
+    fclose(from);
+    if (fclose(to) != 0) ok = false;
+    return ok;
+}
+
+u64
+file_modified_time(const char *path)
+{
+#ifdef _MSC_VER
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attributes)) return 0;
+    u64 ticks = ((u64)attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+    return ticks * 100;
+#else
+    struct stat info;
+    if (stat(path, &info) != 0) return 0;
+    return (u64)info.st_mtim.tv_sec * NANOS_PER_SECOND + (u64)info.st_mtim.tv_nsec;
+#endif
+}
+
 char *
 sprint(const char *fmt, ...)
 {
@@ -38,3 +141,723 @@ sprint(const char *fmt, ...)
 
     return buffer;
 }
+
+const u64 powers_of_10[20] = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+static const char digit_pairs[200] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// The digit count is known up front, so digits go straight to their place,
+// two per division from the end
+usize
+u64_to_ascii(u64 value, char *buffer)
+{
+    usize length = u64_digit_count(value);
+    char *cursor = buffer + length;
+    *cursor = '\0';
+    while (value >= 100) {
+        u64 pair = (value % 100) * 2;
+        value /= 100;
+        cursor -= 2;
+        cursor[0] = digit_pairs[pair];
+        cursor[1] = digit_pairs[pair + 1];
+    }
+    if (value >= 10) {
+        cursor[-2] = digit_pairs[value * 2];
+        cursor[-1] = digit_pairs[value * 2 + 1];
+    } else {
+        cursor[-1] = (char)('0' + value);
+    }
+    return length;
+}
+
+usize
+s64_to_ascii(s64 value, char *buffer)
+{
+    if (value >= 0) return u64_to_ascii((u64)value, buffer);
+    // Negated as unsigned, so INT64_MIN works too
+    buffer[0] = '-';
+    return 1 + u64_to_ascii(0 - (u64)value, buffer + 1);
+}
+
+char *
+u64_string(u64 value)
+{
+    char  digits[INT_ASCII_BUFFER_SIZE];
+    usize length = u64_to_ascii(value, digits);
+    char *result = (char *)malloc(length + 1);
+    memcpy(result, digits, length + 1);
+    return result;
+}
+
+char *
+s64_string(s64 value)
+{
+    char  digits[INT_ASCII_BUFFER_SIZE];
+    usize length = s64_to_ascii(value, digits);
+    char *result = (char *)malloc(length + 1);
+    memcpy(result, digits, length + 1);
+    return result;
+}
+
+u64
+hash_bytes(const void *data, usize size, u64 seed)
+{
+    const u64 m = 0xc6a4a7935bd1e995ull;
+    const int r = 47;
+
+    const u8 *bytes = (const u8 *)data;
+    u64 hash = seed ^ (size * m);
+
+    while (size >= 8) {
+        u64 k;
+        memcpy(&k, bytes, sizeof(k));
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        hash ^= k;
+        hash *= m;
+        bytes += 8;
+        size  -= 8;
+    }
+
+    if (size > 0) {
+        u64 tail = 0;
+        memcpy(&tail, bytes, size);
+        hash ^= tail;
+        hash *= m;
+    }
+
+    hash ^= hash >> r;
+    hash *= m;
+    hash ^= hash >> r;
+    return hash;
+}
+
+u64
+time_now_ns(void)
+{
+#ifdef _MSC_VER
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    u64 seconds   = (u64)counter.QuadPart / (u64)frequency.QuadPart;
+    u64 remainder = (u64)counter.QuadPart % (u64)frequency.QuadPart;
+    return seconds*NANOS_PER_SECOND + remainder*NANOS_PER_SECOND/(u64)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec*NANOS_PER_SECOND + (u64)ts.tv_nsec;
+#endif
+}
+
+void
+sleep_ns(u64 ns)
+{
+#ifdef _MSC_VER
+    Sleep((DWORD)((ns + 999999) / 1000000));
+#else
+    struct timespec ts = {.tv_sec = (time_t)(ns / NANOS_PER_SECOND), .tv_nsec = (long)(ns % NANOS_PER_SECOND)};
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+#endif
+}
+
+void
+thread_yield(void)
+{
+#ifdef _MSC_VER
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+void
+address_wait(volatile u32 *address, u32 expected)
+{
+#ifdef _MSC_VER
+    WaitOnAddress(address, &expected, sizeof(expected), INFINITE);
+#else
+    syscall(SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#endif
+}
+
+void
+address_wake_all(volatile u32 *address)
+{
+#ifdef _MSC_VER
+    WakeByAddressAll((void *)address);
+#else
+    syscall(SYS_futex, address, FUTEX_WAKE_PRIVATE, INT32_MAX, NULL, NULL, 0);
+#endif
+}
+
+u32
+current_thread_id(void)
+{
+    static volatile u32 next_thread_id = 1;
+    static THREAD_LOCAL u32 thread_id  = 0;
+    if (thread_id == 0) thread_id = atomic_fetch_add_u32(&next_thread_id, 1);
+    return thread_id;
+}
+
+u32
+current_process_id(void)
+{
+#ifdef _MSC_VER
+    return (u32)GetCurrentProcessId();
+#else
+    return (u32)getpid();
+#endif
+}
+
+u32
+cpu_count(void)
+{
+    s64 count;
+
+#ifdef _MSC_VER
+    SYSTEM_INFO sys_info;
+    GetSystemInfo(&sys_info);
+    count = (s64)sys_info.dwNumberOfProcessors;
+#else
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    if (count < 1) count = 1;
+
+    return (u32)count;
+}
+
+const char *
+isa_name(Isa isa)
+{
+    switch (isa) {
+    case ISA_AUTO:     return "auto";
+    case ISA_BASELINE: return "baseline";
+    case ISA_SSE42:    return "sse4.2";
+    case ISA_AVX2:     return "avx2";
+    case ISA_AVX512:   return "avx512";
+    default:           return "unknown";
+    }
+}
+
+static void
+cpuid(u32 leaf, u32 subleaf, u32 registers[4])
+{
+#ifdef _MSC_VER
+    __cpuidex((int *)registers, (int)leaf, (int)subleaf);
+#else
+    __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+// Which register state the operating system saves on context switches
+static u64
+xgetbv0(void)
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    u32 low, high;
+    __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return ((u64)high << 32) | low;
+#endif
+}
+
+#define BIT(n)            (1u << (n))
+#define HAS_BITS(x, bits) (((x) & (bits)) == (bits))
+
+Isa
+cpu_isa(void)
+{
+    u32 leaf0[4], leaf1[4], leaf7[4] = {0}, extended[4] = {0};
+    cpuid(0, 0, leaf0);
+    cpuid(1, 0, leaf1);
+    if (leaf0[0] >= 7) cpuid(7, 0, leaf7);
+    cpuid(0x80000000u, 0, extended);
+    if (extended[0] >= 0x80000001u) cpuid(0x80000001u, 0, extended);
+    else                            extended[2] = 0;
+
+    // SSE3, SSSE3, SSE4.1, SSE4.2, POPCNT and CMPXCHG16B
+    u32 v2_ecx = BIT(0) | BIT(9) | BIT(13) | BIT(19) | BIT(20) | BIT(23);
+    if (!HAS_BITS(leaf1[2], v2_ecx)) return ISA_BASELINE;
+
+    // FMA, MOVBE, OSXSAVE, AVX and F16C, BMI1, AVX2 and BMI2, LZCNT, and the
+    // operating system saving the SSE and AVX registers
+    u32 v3_ecx = BIT(12) | BIT(22) | BIT(27) | BIT(28) | BIT(29);
+    u32 v3_ebx = BIT(3) | BIT(5) | BIT(8);
+    if (!HAS_BITS(leaf1[2], v3_ecx) || !HAS_BITS(leaf7[1], v3_ebx) || !HAS_BITS(extended[2], BIT(5))) return ISA_SSE42;
+    u64 xcr0 = xgetbv0();
+    if (!HAS_BITS(xcr0, 0x6)) return ISA_SSE42;
+
+    // AVX-512 F, DQ, CD, BW and VL, and the operating system saving the
+    // opmask and upper ZMM registers
+    u32 v4_ebx = BIT(16) | BIT(17) | BIT(28) | BIT(30) | BIT(31);
+    if (!HAS_BITS(leaf7[1], v4_ebx) || !HAS_BITS(xcr0, 0xe6)) return ISA_AVX2;
+
+    return ISA_AVX512;
+}
+
+#ifdef _MSC_VER
+typedef CRITICAL_SECTION   Mutex;
+typedef CONDITION_VARIABLE CondVar;
+typedef HANDLE             Thread;
+
+#define mutex_init(mutex)                InitializeCriticalSection(mutex)
+#define mutex_destroy(mutex)             DeleteCriticalSection(mutex)
+#define mutex_lock(mutex)                EnterCriticalSection(mutex)
+#define mutex_unlock(mutex)              LeaveCriticalSection(mutex)
+#define cond_var_init(cond_var)          InitializeConditionVariable(cond_var)
+#define cond_var_destroy(cond_var)       UNUSED(cond_var)
+#define cond_var_wait(cond_var, mutex)   SleepConditionVariableCS((cond_var), (mutex), INFINITE)
+#define cond_var_signal(cond_var)        WakeConditionVariable(cond_var)
+#define cond_var_broadcast(cond_var)     WakeAllConditionVariable(cond_var)
+#else
+typedef pthread_mutex_t Mutex;
+typedef pthread_cond_t  CondVar;
+typedef pthread_t       Thread;
+
+#define mutex_init(mutex)                pthread_mutex_init((mutex), NULL)
+#define mutex_destroy(mutex)             pthread_mutex_destroy(mutex)
+#define mutex_lock(mutex)                pthread_mutex_lock(mutex)
+#define mutex_unlock(mutex)              pthread_mutex_unlock(mutex)
+#define cond_var_init(cond_var)          pthread_cond_init((cond_var), NULL)
+#define cond_var_destroy(cond_var)       pthread_cond_destroy(cond_var)
+#define cond_var_wait(cond_var, mutex)   pthread_cond_wait((cond_var), (mutex))
+#define cond_var_signal(cond_var)        pthread_cond_signal(cond_var)
+#define cond_var_broadcast(cond_var)     pthread_cond_broadcast(cond_var)
+#endif
+
+typedef struct {
+    TaskFunc   func;
+    void      *user_data;
+    TaskGroup *group; // NULL if not submitted to a group
+} Task;
+
+// Chase-Lev deque, see "Dynamic Circular Work-Stealing Deque" (Chase and Lev,
+// 2005) and "Correct and Efficient Work-Stealing for Weak Memory Models" (Le
+// et al., 2013). Only the owning worker pushes and takes at the bottom,
+// anyone steals at the top. The capacity is fixed, a full deque makes the
+// owner run the task itself. All atomics here are sequentially consistent,
+// which covers the fences of the weak memory version.
+#define WORKER_DEQUE_CAPACITY 1024
+
+typedef struct {
+    volatile u64 top;
+    volatile u64 bottom;
+    Task         tasks[WORKER_DEQUE_CAPACITY];
+} WorkerDeque;
+
+static bool
+worker_deque_push(WorkerDeque *deque, Task task)
+{
+    u64 bottom = atomic_load_u64(&deque->bottom);
+    u64 top    = atomic_load_u64(&deque->top);
+    if (bottom - top >= WORKER_DEQUE_CAPACITY) return false;
+    deque->tasks[bottom % WORKER_DEQUE_CAPACITY] = task;
+    atomic_store_u64(&deque->bottom, bottom + 1);
+    return true;
+}
+
+// Owner only, newest first
+static bool
+worker_deque_take(WorkerDeque *deque, Task *task)
+{
+    u64 bottom = atomic_load_u64(&deque->bottom);
+    u64 top    = atomic_load_u64(&deque->top);
+    if (top == bottom) return false;
+
+    bottom -= 1;
+    atomic_store_u64(&deque->bottom, bottom);
+    top = atomic_load_u64(&deque->top);
+    if ((s64)(bottom - top) < 0) {
+        atomic_store_u64(&deque->bottom, bottom + 1);
+        return false;
+    }
+
+    *task = deque->tasks[bottom % WORKER_DEQUE_CAPACITY];
+    if (bottom == top) {
+        // The last task, a thief may be after it too
+        bool won = atomic_compare_exchange_u64(&deque->top, top, top + 1);
+        atomic_store_u64(&deque->bottom, bottom + 1);
+        return won;
+    }
+    return true;
+}
+
+// Any thread, oldest first. The task is copied out before claiming it, the
+// copy is only used if the claim succeeds, which means the owner has not
+// reused its slot in the meantime.
+static bool
+worker_deque_steal(WorkerDeque *deque, Task *task)
+{
+    for (;;) {
+        u64 top    = atomic_load_u64(&deque->top);
+        u64 bottom = atomic_load_u64(&deque->bottom);
+        if ((s64)(bottom - top) <= 0) return false;
+
+        *task = deque->tasks[top % WORKER_DEQUE_CAPACITY];
+        if (atomic_compare_exchange_u64(&deque->top, top, top + 1)) return true;
+    }
+}
+
+// Bounded multi-producer multi-consumer queue for tasks from outside the
+// pool, see Dmitry Vyukov's "Bounded MPMC queue". Every cell carries a
+// sequence number telling producers and consumers whose turn it is.
+#define INJECT_QUEUE_CAPACITY 1024 // Power of two
+
+typedef struct {
+    volatile u64 sequence;
+    Task         task;
+} InjectCell;
+
+typedef struct {
+    volatile u64 enqueue_position;
+    volatile u64 dequeue_position;
+    InjectCell   cells[INJECT_QUEUE_CAPACITY];
+} InjectQueue;
+
+static void
+inject_queue_init(InjectQueue *queue)
+{
+    for (u64 i = 0; i < INJECT_QUEUE_CAPACITY; ++i) queue->cells[i].sequence = i;
+}
+
+static bool
+inject_queue_push(InjectQueue *queue, Task task)
+{
+    u64 position = atomic_load_u64(&queue->enqueue_position);
+    for (;;) {
+        InjectCell *cell = &queue->cells[position & (INJECT_QUEUE_CAPACITY - 1)];
+        s64 difference = (s64)(atomic_load_u64(&cell->sequence) - position);
+        if (difference == 0) {
+            if (atomic_compare_exchange_u64(&queue->enqueue_position, position, position + 1)) {
+                cell->task = task;
+                atomic_store_u64(&cell->sequence, position + 1);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false; // Full
+        }
+        position = atomic_load_u64(&queue->enqueue_position);
+    }
+}
+
+static bool
+inject_queue_pop(InjectQueue *queue, Task *task)
+{
+    u64 position = atomic_load_u64(&queue->dequeue_position);
+    for (;;) {
+        InjectCell *cell = &queue->cells[position & (INJECT_QUEUE_CAPACITY - 1)];
+        s64 difference = (s64)(atomic_load_u64(&cell->sequence) - (position + 1));
+        if (difference == 0) {
+            if (atomic_compare_exchange_u64(&queue->dequeue_position, position, position + 1)) {
+                *task = cell->task;
+                atomic_store_u64(&cell->sequence, position + INJECT_QUEUE_CAPACITY);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false; // Empty
+        }
+        position = atomic_load_u64(&queue->dequeue_position);
+    }
+}
+
+typedef struct {
+    ThreadPool *pool;
+    u32         index;
+    Thread      thread;
+    WorkerDeque deque;
+} Worker;
+
+struct ThreadPool {
+    InjectQueue  injected;
+
+    Worker      *workers;
+    u32          thread_count;
+    bool         pin_threads;
+
+    volatile u64 pending_count;  // Submitted tasks not finished yet
+    volatile u32 sleeping_count; // Workers waiting for work_available
+
+    // Only for sleeping and waking up, the queues themselves are lock-free
+    Mutex        mutex;
+    CondVar      work_available;
+    CondVar      all_done;
+    bool         stopping;
+};
+
+static THREAD_LOCAL Worker *current_worker = NULL;
+
+// The calling thread's worker in pool, NULL if it is not one of them
+static Worker *
+thread_pool_current_worker(ThreadPool *pool)
+{
+    if (current_worker) return current_worker->pool == pool ? current_worker : NULL;
+
+    // A pool created by another copy of this file, as the app's is for the
+    // hot reloaded solver library, set current_worker in that copy only
+    for (u32 i = 0; i < pool->thread_count; ++i) {
+#ifdef _MSC_VER
+        if (GetThreadId(pool->workers[i].thread) == GetCurrentThreadId()) return &pool->workers[i];
+#else
+        if (pthread_equal(pool->workers[i].thread, pthread_self())) return &pool->workers[i];
+#endif
+    }
+    return NULL;
+}
+
+static bool
+thread_pool_has_work(ThreadPool *pool)
+{
+    if (atomic_load_u64(&pool->injected.enqueue_position) != atomic_load_u64(&pool->injected.dequeue_position)) return true;
+    for (u32 i = 0; i < pool->thread_count; ++i) {
+        WorkerDeque *deque = &pool->workers[i].deque;
+        if ((s64)(atomic_load_u64(&deque->bottom) - atomic_load_u64(&deque->top)) > 0) return true;
+    }
+    return false;
+}
+
+// Wakes a worker, if any are asleep. Submitters have made their task
+// visible before this, and sleepers count themselves before they last look
+// for work, so one of the two sees the other.
+static void
+thread_pool_wake_worker(ThreadPool *pool)
+{
+    if (atomic_load_u32(&pool->sleeping_count) == 0) return;
+    mutex_lock(&pool->mutex);
+    cond_var_signal(&pool->work_available);
+    mutex_unlock(&pool->mutex);
+}
+
+static bool
+thread_pool_steal(ThreadPool *pool, Worker *thief, u32 first_victim, Task *task)
+{
+    for (u32 i = 0; i < pool->thread_count; ++i) {
+        Worker *victim = &pool->workers[(first_victim + i) % pool->thread_count];
+        if (victim == thief) continue;
+        if (worker_deque_steal(&victim->deque, task)) return true;
+    }
+    return false;
+}
+
+static void
+thread_pool_run_task(ThreadPool *pool, Task *task)
+{
+    task->func(task->user_data);
+    if (task->group) atomic_fetch_add_u32(&task->group->pending, (u32)-1);
+    if (atomic_fetch_add_u64(&pool->pending_count, (u64)-1) == 1) {
+        mutex_lock(&pool->mutex);
+        cond_var_broadcast(&pool->all_done);
+        mutex_unlock(&pool->mutex);
+    }
+}
+
+static void
+thread_pool_submit_task(ThreadPool *pool, Task task)
+{
+    atomic_fetch_add_u64(&pool->pending_count, 1);
+
+    // From a worker of this pool, onto its own deque
+    Worker *worker = thread_pool_current_worker(pool);
+    if (worker) {
+        if (worker_deque_push(&worker->deque, task)) {
+            thread_pool_wake_worker(pool);
+        } else {
+            thread_pool_run_task(pool, &task);
+        }
+        return;
+    }
+
+    // A full queue means 1024 tasks are waiting already, the submitter waits too
+    while (!inject_queue_push(&pool->injected, task)) thread_yield();
+    thread_pool_wake_worker(pool);
+}
+
+static void
+thread_pool_worker(Worker *worker)
+{
+    TRACE_SET_THREAD_NAME("worker");
+    ThreadPool *pool = worker->pool;
+    current_worker = worker;
+
+    for (;;) {
+        Task task;
+        if (worker_deque_take(&worker->deque, &task) ||
+            inject_queue_pop(&pool->injected, &task) ||
+            thread_pool_steal(pool, worker, worker->index + 1, &task)) {
+            thread_pool_run_task(pool, &task);
+            continue;
+        }
+
+        mutex_lock(&pool->mutex);
+        atomic_fetch_add_u32(&pool->sleeping_count, 1);
+        while (!pool->stopping && !thread_pool_has_work(pool)) cond_var_wait(&pool->work_available, &pool->mutex);
+        atomic_fetch_add_u32(&pool->sleeping_count, (u32)-1);
+        bool stop = pool->stopping && !thread_pool_has_work(pool);
+        mutex_unlock(&pool->mutex);
+        if (stop) break;
+    }
+
+    current_worker = NULL;
+}
+
+#ifdef _MSC_VER
+static DWORD WINAPI
+thread_pool_worker_entry(LPVOID worker)
+{
+    thread_pool_worker((Worker *)worker);
+    return 0;
+}
+#else
+static void *
+thread_pool_worker_entry(void *worker)
+{
+    thread_pool_worker((Worker *)worker);
+    return NULL;
+}
+#endif
+
+static void
+pin_thread(Thread thread, u32 cpu)
+{
+#ifdef _MSC_VER
+    SetThreadAffinityMask(thread, (DWORD_PTR)1 << (cpu % (8*sizeof(DWORD_PTR))));
+#else
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu % CPU_SETSIZE, &cpus);
+    pthread_setaffinity_np(thread, sizeof(cpus), &cpus);
+#endif
+}
+
+ThreadPool *
+thread_pool_create(u32 thread_count, bool pin_threads)
+{
+    if (thread_count == 0) thread_count = cpu_count();
+
+    ThreadPool *pool = (ThreadPool *)calloc(1, sizeof(*pool));
+    mutex_init(&pool->mutex);
+    cond_var_init(&pool->work_available);
+    cond_var_init(&pool->all_done);
+    inject_queue_init(&pool->injected);
+
+    pool->thread_count = thread_count;
+    pool->pin_threads  = pin_threads;
+    pool->workers      = (Worker *)calloc(thread_count, sizeof(*pool->workers));
+    u32 cpus = cpu_count();
+    for (u32 i = 0; i < thread_count; ++i) {
+        Worker *worker = &pool->workers[i];
+        worker->pool  = pool;
+        worker->index = i;
+#ifdef _MSC_VER
+        worker->thread = CreateThread(NULL, 0, thread_pool_worker_entry, worker, 0, NULL);
+#else
+        pthread_create(&worker->thread, NULL, thread_pool_worker_entry, worker);
+#endif
+        if (pin_threads) pin_thread(worker->thread, i % cpus);
+    }
+
+    return pool;
+}
+
+u32
+thread_pool_thread_count(ThreadPool *pool)
+{
+    return pool->thread_count;
+}
+
+void
+thread_pool_submit(ThreadPool *pool, TaskFunc func, void *user_data)
+{
+    thread_pool_submit_task(pool, (Task){.func = func, .user_data = user_data});
+}
+
+void
+thread_pool_submit_group(ThreadPool *pool, TaskGroup *group, TaskFunc func, void *user_data)
+{
+    atomic_fetch_add_u32(&group->pending, 1);
+    thread_pool_submit_task(pool, (Task){.func = func, .user_data = user_data, .group = group});
+}
+
+void
+thread_pool_wait_group(ThreadPool *pool, TaskGroup *group)
+{
+    // Only takes from the deques. Tasks on the shared queue are whole
+    // solvers or input files, which may wait on a lock the caller holds, and
+    // a thread outside the pool leaves its parts to the workers anyway.
+    Worker *worker = thread_pool_current_worker(pool);
+    u32     victim = worker ? worker->index + 1 : 0;
+    while (atomic_load_u32(&group->pending) != 0) {
+        Task task;
+        if ((worker && worker_deque_take(&worker->deque, &task)) || thread_pool_steal(pool, worker, victim++, &task)) {
+            thread_pool_run_task(pool, &task);
+        } else {
+            thread_yield();
+        }
+    }
+}
+
+void
+thread_pool_wait(ThreadPool *pool)
+{
+    mutex_lock(&pool->mutex);
+    while (atomic_load_u64(&pool->pending_count) != 0) cond_var_wait(&pool->all_done, &pool->mutex);
+    mutex_unlock(&pool->mutex);
+}
+
+void
+thread_pool_destroy(ThreadPool *pool)
+{
+    mutex_lock(&pool->mutex);
+    pool->stopping = true;
+    cond_var_broadcast(&pool->work_available);
+    mutex_unlock(&pool->mutex);
+
+    for (u32 i = 0; i < pool->thread_count; ++i) {
+#ifdef _MSC_VER
+        WaitForSingleObject(pool->workers[i].thread, INFINITE);
+        CloseHandle(pool->workers[i].thread);
+#else
+        pthread_join(pool->workers[i].thread, NULL);
+#endif
+    }
+
+    cond_var_destroy(&pool->all_done);
+    cond_var_destroy(&pool->work_available);
+    mutex_destroy(&pool->mutex);
+    free(pool->workers);
+    free(pool);
+}
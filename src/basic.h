@@ -4,6 +4,11 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <stdbool.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 // Fundamental types
 typedef size_t usize;
@@ -24,9 +29,240 @@ typedef float f32;
 #define UNUSED(x) (void)(x);
 #define ARRAY_LENGTH(arr) (sizeof((arr)) / sizeof(*(arr)))
 
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+#define NANOS_PER_SECOND 1000000000ull
+
+// Returns NULL if the file could not be opened
 char *read_entire_file(const char *path);
+bool  write_entire_file(const char *path, const void *data, usize size);
+// Creates path and any missing parent directories
+bool  create_directories(const char *path);
+bool  copy_file(const char *from_path, const char *to_path);
+// Last modification time in nanoseconds since some fixed point, 0 if the file does not exist
+u64   file_modified_time(const char *path);
 char *sprint(const char *fmt, ...);
 
+// Integer formatting without libc. The _to_ascii functions write the
+// decimal digits and a zero byte into buffer, which needs
+// INT_ASCII_BUFFER_SIZE bytes, and return the digit count (with the sign).
+// The _string functions return a malloc'ed copy, like sprint.
+#define INT_ASCII_BUFFER_SIZE 21
+
+usize u64_to_ascii(u64 value, char *buffer);
+usize s64_to_ascii(s64 value, char *buffer);
+char *u64_string(u64 value);
+char *s64_string(s64 value);
+
+// 10^0 to 10^19, every power of 10 that fits in a u64
+extern const u64 powers_of_10[20];
+
+// Decimal digits of value, 1 for 0. The bit length gives the digit count
+// up to one (1233/4096 is just above log10(2)), the table settles it. Both
+// look at value | 1, which has the same digit count and makes 0 count as 1.
+static inline u32
+u64_digit_count(u64 value)
+{
+#ifdef _MSC_VER
+    unsigned long top_bit;
+    _BitScanReverse64(&top_bit, value | 1);
+    u32 bit_count = (u32)top_bit + 1;
+#else
+    u32 bit_count = 64 - (u32)__builtin_clzll(value | 1);
+#endif
+    u32 digit_count = (bit_count * 1233) >> 12;
+    return digit_count + ((value | 1) >= powers_of_10[digit_count]);
+}
+
+// value without its low digit_count decimal digits, digit_count < 20
+static inline u64
+u64_high_digits(u64 value, u32 digit_count)
+{
+    return value / powers_of_10[digit_count];
+}
+
+// The low digit_count decimal digits of value, digit_count < 20
+static inline u64
+u64_low_digits(u64 value, u32 digit_count)
+{
+    return value % powers_of_10[digit_count];
+}
+
+// Decimal digit at index, counting from the lowest at 0, index < 20
+static inline u32
+u64_digit_at(u64 value, u32 index)
+{
+    return (u32)(value / powers_of_10[index] % 10);
+}
+
+// Fast non-cryptographic 64-bit hash (MurmurHash64A)
+u64 hash_bytes(const void *data, usize size, u64 seed);
+
+// Monotonic clock, only meaningful as a difference between two calls
+u64 time_now_ns(void);
+
+void  sleep_ns(u64 ns);
+// Gives the rest of the time slice to another thread
+void  thread_yield(void);
+
+// Blocks while *address holds expected, without a lock, so it works on
+// zero initialized statics (a futex, WaitOnAddress on Windows). It may also
+// return early, callers check their condition again in a loop. Wakes are
+// only seen by threads already waiting, store the new value first.
+void address_wait(volatile u32 *address, u32 expected);
+void address_wake_all(volatile u32 *address);
+
+// Small sequential id of the calling thread, the first thread to ask gets 1
+u32 current_thread_id(void);
+// The operating system's id of this process
+u32 current_process_id(void);
+
+// Returns the value before the addition
+static inline u64
+atomic_fetch_add_u64(volatile u64 *target, u64 value)
+{
+#ifdef _MSC_VER
+    return (u64)_InterlockedExchangeAdd64((volatile long long *)target, (long long)value);
+#else
+    return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline u32
+atomic_fetch_add_u32(volatile u32 *target, u32 value)
+{
+#ifdef _MSC_VER
+    return (u32)_InterlockedExchangeAdd((volatile long *)target, (long)value);
+#else
+    return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline u32
+atomic_load_u32(volatile u32 *target)
+{
+#ifdef _MSC_VER
+    return (u32)_InterlockedOr((volatile long *)target, 0);
+#else
+    return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline void
+atomic_store_u32(volatile u32 *target, u32 value)
+{
+#ifdef _MSC_VER
+    _InterlockedExchange((volatile long *)target, (long)value);
+#else
+    __atomic_store_n(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+// Returns the value before the exchange
+static inline u32
+atomic_exchange_u32(volatile u32 *target, u32 value)
+{
+#ifdef _MSC_VER
+    return (u32)_InterlockedExchange((volatile long *)target, (long)value);
+#else
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline u64
+atomic_load_u64(volatile u64 *target)
+{
+#ifdef _MSC_VER
+    return (u64)_InterlockedOr64((volatile long long *)target, 0);
+#else
+    return __atomic_load_n(target, __ATOMIC_SEQ_CST);
+#endif
+}
+
+static inline void
+atomic_store_u64(volatile u64 *target, u64 value)
+{
+#ifdef _MSC_VER
+    _InterlockedExchange64((volatile long long *)target, (long long)value);
+#else
+    __atomic_store_n(target, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+// Stores desired if target holds expected. Returns whether it did.
+static inline bool
+atomic_compare_exchange_u64(volatile u64 *target, u64 expected, u64 desired)
+{
+#ifdef _MSC_VER
+    return (u64)_InterlockedCompareExchange64((volatile long long *)target, (long long)desired, (long long)expected) == expected;
+#else
+    return __atomic_compare_exchange_n(target, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+}
+
+// Lock for short critical sections, 0 is unlocked. Waiters yield rather than
+// spin, the holder may be waiting for a cpu itself.
+static inline void
+spin_lock(volatile u32 *lock)
+{
+    while (atomic_exchange_u32(lock, 1) != 0) thread_yield();
+}
+
+static inline void
+spin_unlock(volatile u32 *lock)
+{
+    atomic_store_u32(lock, 0);
+}
+
+// x86-64 instruction set levels the solvers are built for, see days.h
+typedef enum {
+    ISA_AUTO = -1, // The highest level the cpu supports
+    ISA_BASELINE,  // x86-64, SSE2
+    ISA_SSE42,     // x86-64-v2, SSE4.2 and POPCNT
+    ISA_AVX2,      // x86-64-v3, AVX2, BMI2 and FMA
+    ISA_AVX512,    // x86-64-v4, AVX-512 F, BW, CD, DQ and VL
+    ISA_COUNT,
+} Isa;
+
+const char *isa_name(Isa isa);
+// Highest level both the cpu and the operating system support
+Isa         cpu_isa(void);
+
+// Thread pool
+//
+// Work stealing over a fixed set of worker threads. Every worker has its own
+// deque: tasks submitted from a worker go onto it and are run newest first,
+// while idle workers steal the oldest ones. Tasks submitted from any other
+// thread go through a lock-free queue the workers share, and start roughly
+// in submission order. thread_pool_wait() blocks until every submitted task
+// has finished, and may not be called from a task.
+//
+// Tasks that split up their own work submit the parts into a TaskGroup and
+// wait on it with thread_pool_wait_group(), which runs parts from the
+// workers' deques while it waits, so a task waiting for its parts never
+// holds up a worker. It never runs tasks submitted from outside the pool.
+typedef void (*TaskFunc)(void *user_data);
+typedef struct ThreadPool ThreadPool;
+
+typedef struct {
+    volatile u32 pending; // Submitted tasks not finished yet, zero initialized is empty
+} TaskGroup;
+
+u32         cpu_count(void);
+// 0 threads means one per cpu. With pin_threads, worker i only runs on cpu i
+// modulo the cpu count.
+ThreadPool *thread_pool_create(u32 thread_count, bool pin_threads);
+u32         thread_pool_thread_count(ThreadPool *pool);
+void        thread_pool_submit(ThreadPool *pool, TaskFunc func, void *user_data);
+void        thread_pool_submit_group(ThreadPool *pool, TaskGroup *group, TaskFunc func, void *user_data);
+void        thread_pool_wait_group(ThreadPool *pool, TaskGroup *group);
+void        thread_pool_wait(ThreadPool *pool);
+void        thread_pool_destroy(ThreadPool *pool);
+
 static inline u64
 absolute_value(s64 val)
 {
@@ -0,0 +1,233 @@
+#include "containers.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define CONTAINERS_SSE2
+#endif
+
+#define ALLOC_TRACK_REDIRECT
+#include "alloc_track.h"
+
+void
+vec_grow_(void **items, usize *capacity, usize wanted, usize item_size)
+{
+    usize new_capacity = *capacity ? *capacity : VEC_MIN_CAPACITY;
+    while (new_capacity < wanted) new_capacity *= 2;
+    *items    = realloc(*items, new_capacity * item_size);
+    *capacity = new_capacity;
+}
+
+#define CONTROL_EMPTY   0x80
+#define CONTROL_DELETED 0xFE
+
+// Keys from the solvers are often small and sequential, so they are mixed
+// before use (the MurmurHash3 finalizer). The low 7 bits go into the control
+// byte, the rest picks the group.
+static inline u64
+hash_u64(u64 key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ull;
+    key ^= key >> 33;
+    return key;
+}
+
+// Bit i set for every control byte of the group equal to byte
+static inline u32
+group_match(const u8 *group, u8 byte)
+{
+#ifdef CONTAINERS_SSE2
+    __m128i controls = _mm_loadu_si128((const __m128i *)group);
+    return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8((char)byte)));
+#else
+    u32 mask = 0;
+    for (u32 i = 0; i < U64_MAP_GROUP_SIZE; ++i) mask |= (u32)(group[i] == byte) << i;
+    return mask;
+#endif
+}
+
+// Bit i set for every empty or deleted control byte of the group, the only
+// ones with the top bit set
+static inline u32
+group_match_free(const u8 *group)
+{
+#ifdef CONTAINERS_SSE2
+    return (u32)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+#else
+    u32 mask = 0;
+    for (u32 i = 0; i < U64_MAP_GROUP_SIZE; ++i) mask |= (u32)(group[i] >= CONTROL_EMPTY) << i;
+    return mask;
+#endif
+}
+
+static inline u32
+lowest_bit_index(u32 mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (u32)index;
+#else
+    return (u32)__builtin_ctz(mask);
+#endif
+}
+
+// Groups are probed in a triangular sequence, which visits every one of a
+// power of two group count before repeating
+#define FOR_EACH_PROBED_GROUP(map, hash, group_index)                                             \
+    for (usize group_mask_ = (map)->capacity / U64_MAP_GROUP_SIZE - 1, step_ = 0,               \
+               group_index = ((hash) >> 7) & group_mask_;                                        \
+         step_ <= group_mask_;                                                                   \
+         ++step_, group_index = (group_index + step_) & group_mask_)
+
+// Index of key's slot, or capacity if it is not in the map
+static usize
+u64_map_find(const U64Map *map, u64 key, u64 hash)
+{
+    if (map->count == 0) return map->capacity;
+
+    u8 h2 = (u8)(hash & 0x7F);
+    FOR_EACH_PROBED_GROUP(map, hash, group_index) {
+        const u8 *group = map->control + group_index * U64_MAP_GROUP_SIZE;
+        for (u32 matches = group_match(group, h2); matches; matches &= matches - 1) {
+            usize index = group_index * U64_MAP_GROUP_SIZE + lowest_bit_index(matches);
+            if (map->keys[index] == key) return index;
+        }
+        // An empty slot ends the probe, key would have gone there
+        if (group_match(group, CONTROL_EMPTY)) break;
+    }
+    return map->capacity;
+}
+
+// First empty or deleted slot on key's probe sequence. The map has one.
+static usize
+u64_map_find_free(const U64Map *map, u64 hash)
+{
+    FOR_EACH_PROBED_GROUP(map, hash, group_index) {
+        u32 free_slots = group_match_free(map->control + group_index * U64_MAP_GROUP_SIZE);
+        if (free_slots) return group_index * U64_MAP_GROUP_SIZE + lowest_bit_index(free_slots);
+    }
+    return map->capacity;
+}
+
+static void
+u64_map_resize(U64Map *map, usize capacity)
+{
+    U64Map old = *map;
+
+    map->control    = (u8 *)malloc(capacity);
+    map->keys       = (u64 *)malloc(capacity * sizeof(*map->keys));
+    map->values     = (u64 *)malloc(capacity * sizeof(*map->values));
+    map->capacity   = capacity;
+    map->tombstones = 0;
+    memset(map->control, CONTROL_EMPTY, capacity);
+
+    for (usize i = 0; i < old.capacity; ++i) {
+        if (!u64_map_occupied(&old, i)) continue;
+        u64   hash  = hash_u64(old.keys[i]);
+        usize index = u64_map_find_free(map, hash);
+        map->control[index] = (u8)(hash & 0x7F);
+        map->keys[index]    = old.keys[i];
+        map->values[index]  = old.values[i];
+    }
+
+    free(old.control);
+    free(old.keys);
+    free(old.values);
+}
+
+// Maximum load of 7/8, counting tombstones
+static inline bool
+u64_map_fits(const U64Map *map, usize count)
+{
+    return count * 8 <= map->capacity * 7;
+}
+
+void
+u64_map_reserve(U64Map *map, usize count)
+{
+    if (u64_map_fits(map, count + map->tombstones)) return;
+
+    usize capacity = map->capacity ? map->capacity : U64_MAP_GROUP_SIZE;
+    while (count * 8 > capacity * 7) capacity *= 2;
+    u64_map_resize(map, capacity);
+}
+
+bool
+u64_map_get(const U64Map *map, u64 key, u64 *value)
+{
+    usize index = u64_map_find(map, key, hash_u64(key));
+    if (index == map->capacity) return false;
+    *value = map->values[index];
+    return true;
+}
+
+bool
+u64_map_contains(const U64Map *map, u64 key)
+{
+    return u64_map_find(map, key, hash_u64(key)) != map->capacity;
+}
+
+u64 *
+u64_map_slot(U64Map *map, u64 key)
+{
+    u64   hash  = hash_u64(key);
+    usize index = u64_map_find(map, key, hash);
+    if (index != map->capacity) return &map->values[index];
+
+    u64_map_reserve(map, map->count + 1);
+    index = u64_map_find_free(map, hash);
+    if (map->control[index] == CONTROL_DELETED) map->tombstones -= 1;
+    map->control[index] = (u8)(hash & 0x7F);
+    map->keys[index]    = key;
+    map->values[index]  = 0;
+    map->count += 1;
+    return &map->values[index];
+}
+
+void
+u64_map_put(U64Map *map, u64 key, u64 value)
+{
+    *u64_map_slot(map, key) = value;
+}
+
+bool
+u64_map_remove(U64Map *map, u64 key)
+{
+    usize index = u64_map_find(map, key, hash_u64(key));
+    if (index == map->capacity) return false;
+
+    // A group that was never full ended every probe through it, so the slot
+    // can go back to empty. Otherwise later keys may have probed past it.
+    usize group_index = index / U64_MAP_GROUP_SIZE;
+    if (group_match(map->control + group_index * U64_MAP_GROUP_SIZE, CONTROL_EMPTY)) {
+        map->control[index] = CONTROL_EMPTY;
+    } else {
+        map->control[index] = CONTROL_DELETED;
+        map->tombstones += 1;
+    }
+    map->count -= 1;
+    return true;
+}
+
+void
+u64_map_clear(U64Map *map)
+{
+    if (map->capacity) memset(map->control, CONTROL_EMPTY, map->capacity);
+    map->count      = 0;
+    map->tombstones = 0;
+}
+
+void
+u64_map_free(U64Map *map)
+{
+    free(map->control);
+    free(map->keys);
+    free(map->values);
+    *map = (U64Map){0};
+}
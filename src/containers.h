@@ -0,0 +1,93 @@
+#ifndef CONTAINERS_H
+#define CONTAINERS_H
+
+#include "basic.h"
+
+#include <string.h>
+
+// Growable arrays and a hash map for the solvers, in place of stb_ds on hot
+// paths. Both keep their bookkeeping in a plain struct next to the data
+// instead of in a header before it, and zero initialized is empty.
+
+// Vectors
+//
+// Any struct with items, count and capacity works with the vec_ macros, VEC
+// declares one. Structure of arrays layouts are several vectors filled in
+// step, which keeps the loops over one field dense.
+#define VEC(T) struct { T *items; usize count; usize capacity; }
+
+typedef VEC(s64) S64Vec;
+typedef VEC(u64) U64Vec;
+typedef VEC(s32) S32Vec;
+typedef VEC(u8)  U8Vec;
+
+// Capacity grows by doubling, from VEC_MIN_CAPACITY
+#define VEC_MIN_CAPACITY 16
+
+void vec_grow_(void **items, usize *capacity, usize wanted, usize item_size);
+
+#define vec_reserve(vec, wanted)                                                             \
+    ((wanted) > (vec)->capacity                                                              \
+        ? vec_grow_((void **)&(vec)->items, &(vec)->capacity, (wanted), sizeof(*(vec)->items)) \
+        : (void)0)
+#define vec_push(vec, value)                    \
+    do {                                        \
+        vec_reserve((vec), (vec)->count + 1);   \
+        (vec)->items[(vec)->count++] = (value); \
+    } while (0)
+// Appends n items copied from values
+#define vec_push_many(vec, values, n)                                               \
+    do {                                                                            \
+        vec_reserve((vec), (vec)->count + (n));                                     \
+        memcpy((vec)->items + (vec)->count, (values), (n) * sizeof(*(vec)->items)); \
+        (vec)->count += (n);                                                        \
+    } while (0)
+#define vec_clear(vec) ((vec)->count = 0)
+#define vec_free(vec)                          \
+    do {                                       \
+        free((vec)->items);                    \
+        (vec)->items    = NULL;                \
+        (vec)->count    = 0;                   \
+        (vec)->capacity = 0;                   \
+    } while (0)
+
+// Hash map from u64 keys to u64 values
+//
+// Open addressing over groups of U64_MAP_GROUP_SIZE slots, like Abseil's
+// Swiss tables. Every slot has a control byte: empty, deleted, or 7 bits of
+// the key's hash. A lookup compares a whole group of control bytes with the
+// hash at once (SSE2 where available), and only looks at the keys that
+// match, so the key array is rarely touched for absent keys.
+#define U64_MAP_GROUP_SIZE 16
+
+typedef struct {
+    u8   *control;    // capacity of them
+    u64  *keys;
+    u64  *values;
+    usize count;
+    usize capacity;   // 0 or a power of two, at least U64_MAP_GROUP_SIZE
+    usize tombstones; // Deleted slots, they still count towards the load
+} U64Map;
+
+// Returns false, and leaves *value alone, if key is not in the map
+bool u64_map_get(const U64Map *map, u64 key, u64 *value);
+bool u64_map_contains(const U64Map *map, u64 key);
+void u64_map_put(U64Map *map, u64 key, u64 value);
+// Returns the value of key, inserting a 0 first if it is missing. The
+// pointer is valid until the next insertion, for counting with `+= 1`.
+u64 *u64_map_slot(U64Map *map, u64 key);
+// Returns false if key was not in the map
+bool u64_map_remove(U64Map *map, u64 key);
+void u64_map_reserve(U64Map *map, usize count);
+void u64_map_clear(U64Map *map);
+void u64_map_free(U64Map *map);
+
+// Iterate with
+//     for (usize i = 0; i < map.capacity; ++i) if (u64_map_occupied(&map, i)) ... map.keys[i], map.values[i]
+static inline bool
+u64_map_occupied(const U64Map *map, usize index)
+{
+    return map->control[index] < 0x80;
+}
+
+#endif
@@ -0,0 +1,155 @@
+// Microbenchmark of containers.h against stb_ds, on workloads the size of a
+// day's input. Run with aoc_solve --bench-containers N.
+
+#include "containers_bench.h"
+#include "containers.h"
+
+// stb_ds's hash map macros use typeof, which strict C17 only spells __typeof__
+#if defined(__GNUC__) && !defined(__clang__) && !defined(typeof)
+#define typeof __typeof__
+#endif
+#include "stb_ds.h"
+
+#include <stdio.h>
+
+typedef struct {
+    u64 key;
+    u64 value;
+} StbU64Entry;
+
+// Roughly what day inputs look like: ids in the hundreds of trillions, a
+// few of them repeated
+static u64 *
+make_keys(usize count, u64 seed)
+{
+    u64 *keys  = (u64 *)malloc(count * sizeof(*keys));
+    u64  state = seed;
+    for (usize i = 0; i < count; ++i) {
+        state   = state * 6364136223846793005ull + 1442695040888963407ull;
+        keys[i] = (state >> 16) % 600000000000000ull;
+        if (i % 8 == 7) keys[i] = keys[i / 2];
+    }
+    return keys;
+}
+
+typedef struct {
+    const u64 *keys;
+    const u64 *missing_keys;
+    usize      count;
+    u64        checksum; // Keeps the work from being optimized away
+} Workload;
+
+static void
+bench_stb_push(Workload *work)
+{
+    s64 *array = NULL;
+    for (usize i = 0; i < work->count; ++i) arrput(array, (s64)work->keys[i]);
+    work->checksum += (u64)array[arrlenu(array) - 1];
+    arrfree(array);
+}
+
+static void
+bench_vec_push(Workload *work)
+{
+    S64Vec vec = {0};
+    for (usize i = 0; i < work->count; ++i) vec_push(&vec, (s64)work->keys[i]);
+    work->checksum += (u64)vec.items[vec.count - 1];
+    vec_free(&vec);
+}
+
+static void
+bench_stb_count(Workload *work)
+{
+    StbU64Entry *map = NULL;
+    for (usize i = 0; i < work->count; ++i) {
+        ptrdiff_t index = hmgeti(map, work->keys[i]);
+        if (index < 0) hmput(map, work->keys[i], 1);
+        else           map[index].value += 1;
+    }
+    work->checksum += hmlenu(map);
+    hmfree(map);
+}
+
+static void
+bench_map_count(Workload *work)
+{
+    U64Map map = {0};
+    for (usize i = 0; i < work->count; ++i) *u64_map_slot(&map, work->keys[i]) += 1;
+    work->checksum += map.count;
+    u64_map_free(&map);
+}
+
+static void
+bench_stb_lookup(Workload *work)
+{
+    StbU64Entry *map = NULL;
+    for (usize i = 0; i < work->count; ++i) hmput(map, work->keys[i], i);
+    for (usize i = 0; i < work->count; ++i) {
+        work->checksum += (u64)hmgeti(map, work->keys[i]);
+        work->checksum += (u64)hmgeti(map, work->missing_keys[i]);
+    }
+    hmfree(map);
+}
+
+static void
+bench_map_lookup(Workload *work)
+{
+    U64Map map = {0};
+    for (usize i = 0; i < work->count; ++i) u64_map_put(&map, work->keys[i], i);
+    for (usize i = 0; i < work->count; ++i) {
+        u64 value = 0;
+        work->checksum += u64_map_get(&map, work->keys[i], &value) ? value : 0;
+        work->checksum += u64_map_contains(&map, work->missing_keys[i]);
+    }
+    u64_map_free(&map);
+}
+
+typedef void (*BenchFunc)(Workload *work);
+
+static u64
+min_duration_ns(BenchFunc func, Workload *work, u32 repeat_count)
+{
+    u64 min_ns = UINT64_MAX;
+    for (u32 i = 0; i < repeat_count; ++i) {
+        u64 begin_ns = time_now_ns();
+        func(work);
+        u64 duration_ns = time_now_ns() - begin_ns;
+        if (duration_ns < min_ns) min_ns = duration_ns;
+    }
+    return min_ns;
+}
+
+void
+containers_bench(u32 repeat_count)
+{
+    static const struct {
+        const char *name;
+        BenchFunc   stb_ds;
+        BenchFunc   ours;
+    } benches[] = {
+        {"push",           bench_stb_push,   bench_vec_push},
+        {"count",          bench_stb_count,  bench_map_count},
+        {"insert, lookup", bench_stb_lookup, bench_map_lookup},
+    };
+    static const usize counts[] = {1000, 20000, 1000000};
+
+    if (repeat_count < 1) repeat_count = 1;
+    printf("Benchmarking containers (%u runs each, minimum durations)...\n\n", repeat_count);
+    printf("%-16s %8s %14s %14s %9s\n", "workload", "items", "stb_ds (us)", "ours (us)", "speedup");
+    for (usize c = 0; c < ARRAY_LENGTH(counts); ++c) {
+        Workload work = {
+            .keys         = make_keys(counts[c], 1),
+            .missing_keys = make_keys(counts[c], 2),
+            .count        = counts[c],
+        };
+        for (usize b = 0; b < ARRAY_LENGTH(benches); ++b) {
+            u64 stb_ds_ns = min_duration_ns(benches[b].stb_ds, &work, repeat_count);
+            u64 ours_ns   = min_duration_ns(benches[b].ours, &work, repeat_count);
+            printf("%-16s %8zu %14.1f %14.1f %8.2fx\n", benches[b].name, counts[c],
+                   (f64)stb_ds_ns / 1000.0, (f64)ours_ns / 1000.0, ours_ns ? (f64)stb_ds_ns / (f64)ours_ns : 0.0);
+        }
+        free((void *)work.keys);
+        free((void *)work.missing_keys);
+    }
+    fflush(stdout);
+}
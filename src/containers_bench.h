@@ -0,0 +1,9 @@
+#ifndef CONTAINERS_BENCH_H
+#define CONTAINERS_BENCH_H
+
+#include "basic.h"
+
+// Times containers.h against stb_ds and prints a table, part of aoc_solve
+void containers_bench(u32 repeat_count);
+
+#endif
@@ -1,55 +1,127 @@
 #include "days.h"
 #include "basic.h"
+#include "trace.h"
+#include "parsed_input.h"
+#include "parallel_lines.h"
 
 #include "sv.h"
 
-char *
-day1_part1(const char *input, usize input_length)
+#include <string.h>
+
+#define ALLOC_TRACK_REDIRECT
+#include "alloc_track.h"
+
+#define DAY1_PARSE_GRAIN_SIZE (64*1024)
+
+typedef struct {
+    s32  *rotations; // Clicks to turn the dial, positive to the right
+    usize count;
+} Day1Input;
+
+// Rotations of one chunk of lines, see parallel_lines.h
+typedef struct {
+    s32  *rotations;
+    usize count;
+} Day1Chunk;
+
+static void
+day1_parse_lines(StringView lines, void *state, void *user_data)
 {
-    StringView sv = sv_from_parts(input, input_length);
-    sv = sv_trim(sv);
+    UNUSED(user_data);
+    Day1Chunk *chunk = (Day1Chunk *)state;
 
-    u32 n_0 = 0;
-    s32 dial = 50;
-    while (sv.length) {
+    // One rotation per line at most
+    usize line_count = 1;
+    for (usize i = 0; i < lines.length; ++i) line_count += lines.begin[i] == '\n';
+
+    chunk->rotations = (s32 *)malloc(line_count * sizeof(*chunk->rotations));
+    while (lines.length) {
         StringView this_line;
-        sv_split_first(sv, '\n', &this_line, &sv);
+        sv_split_first(lines, '\n', &this_line, &lines);
         this_line = sv_trim(this_line);
+        if (this_line.length == 0) continue;
 
         StringView dir_sv = sv_take_and_consume(&this_line, 1);
-        s32 dir = sv_eq(dir_sv, SV_LIT("R")) ? 1 : -1;
+        s32        dir    = sv_eq(dir_sv, SV_LIT("R")) ? 1 : -1;
         s64 scalar;
         sv_to_int64(this_line, &scalar);
+        chunk->rotations[chunk->count++] = dir * (s32)scalar;
+    }
+}
+
+static void
+day1_append_rotations(void *result, void *state, void *user_data)
+{
+    UNUSED(user_data);
+    Day1Input *parsed = (Day1Input *)result;
+    Day1Chunk *chunk  = (Day1Chunk *)state;
+    memcpy(parsed->rotations + parsed->count, chunk->rotations, chunk->count * sizeof(*chunk->rotations));
+    parsed->count += chunk->count;
+    free(chunk->rotations);
+}
+
+static void *
+day1_parse(SolverContext *context, const char *input, usize input_length)
+{
+    TRACE_BEGIN("day1_parse");
+    StringView sv = sv_from_parts(input, input_length);
+    sv = sv_trim(sv);
+
+    usize line_count = 1;
+    for (usize i = 0; i < sv.length; ++i) line_count += sv.begin[i] == '\n';
+
+    Day1Input *parsed = (Day1Input *)malloc(sizeof(*parsed));
+    parsed->rotations = (s32 *)malloc(line_count * sizeof(*parsed->rotations));
+    parsed->count     = 0;
+    parallel_reduce_lines(context->pool, sv, DAY1_PARSE_GRAIN_SIZE, sizeof(Day1Chunk),
+                          day1_parse_lines, day1_append_rotations, parsed, NULL);
+
+    TRACE_END("day1_parse");
+    return parsed;
+}
+
+static void
+day1_free(void *parsed)
+{
+    Day1Input *day1_input = (Day1Input *)parsed;
+    free(day1_input->rotations);
+    free(day1_input);
+}
+
+static ParsedInputCache day1_inputs = PARSED_INPUT_CACHE(day1_parse, day1_free);
+
+char *
+day1_part1(SolverContext *context, const char *input, usize input_length)
+{
+    TRACE_BEGIN("day1_part1");
+    const Day1Input *parsed = (const Day1Input *)parsed_input_acquire(&day1_inputs, context, input, input_length);
+
+    u32 n_0 = 0;
+    s32 dial = 50;
+    for (usize i = 0; i < parsed->count; ++i) {
         dial += 100; // Offset to make mod of negative safe
-        dial += dir * scalar;
+        dial += parsed->rotations[i];
         dial %= 100;
         if (dial == 0) n_0 += 1;
     }
 
-    char *result = sprint("%u", n_0);
+    parsed_input_release(&day1_inputs, parsed);
+    char *result = u64_string(n_0);
 
+    TRACE_END("day1_part1");
     return result;
 }
 
 char *
-day1_part2(const char *input, usize input_length)
+day1_part2(SolverContext *context, const char *input, usize input_length)
 {
-    StringView sv = sv_from_parts(input, input_length);
-    sv = sv_trim(sv);
+    TRACE_BEGIN("day1_part2");
+    const Day1Input *parsed = (const Day1Input *)parsed_input_acquire(&day1_inputs, context, input, input_length);
 
     u32 n_0 = 0;
     s32 dial = 50;
-    while (sv.length) {
-        StringView this_line;
-        sv_split_first(sv, '\n', &this_line, &sv);
-        this_line = sv_trim(this_line);
-
-        StringView dir_sv = sv_take_and_consume(&this_line, 1);
-        s32        dir    = sv_eq(dir_sv, SV_LIT("R")) ? 1 : -1;
-        s64 scalar;
-        sv_to_int64(this_line, &scalar);
-
-        s64  value    = dir * scalar;
+    for (usize i = 0; i < parsed->count; ++i) {
+        s64  value    = parsed->rotations[i];
         bool was_zero = dial == 0;
         dial += value;
 
@@ -66,7 +138,46 @@ day1_part2(const char *input, usize input_length)
         dial = ((dial % 100) + 100) % 100;
     }
 
-    char *result = sprint("%u", n_0);
+    parsed_input_release(&day1_inputs, parsed);
+    char *result = u64_string(n_0);
 
+    TRACE_END("day1_part2");
     return result;
 }
+
+// Part 1's zero count falls out of part 2's dial walk. Part 1 keeps its dial
+// within (-100, 100), so it is 0 exactly when part 2's is.
+SolverAnswers
+day1_solve_both(SolverContext *context, const char *input, usize input_length)
+{
+    TRACE_BEGIN("day1_solve_both");
+    const Day1Input *parsed = (const Day1Input *)parsed_input_acquire(&day1_inputs, context, input, input_length);
+
+    u32 stops_at_0  = 0;
+    u32 passes_by_0 = 0;
+    s32 dial = 50;
+    for (usize i = 0; i < parsed->count; ++i) {
+        s64  value    = parsed->rotations[i];
+        bool was_zero = dial == 0;
+        dial += value;
+
+        if (dial < 0 && !was_zero) {
+            passes_by_0 += 1;
+        }
+
+        passes_by_0 += absolute_value(dial) / 100;
+
+        if (dial == 0) {
+            passes_by_0 += 1;
+        }
+
+        dial = ((dial % 100) + 100) % 100;
+        if (dial == 0) stops_at_0 += 1;
+    }
+
+    parsed_input_release(&day1_inputs, parsed);
+    SolverAnswers answers = {u64_string(stops_at_0), u64_string(passes_by_0)};
+
+    TRACE_END("day1_solve_both");
+    return answers;
+}
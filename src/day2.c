@@ -1,17 +1,43 @@
 #include "days.h"
 #include "basic.h"
+#include "trace.h"
+#include "parsed_input.h"
 
 #include "sv.h"
 
-#include <string.h>
+#define ALLOC_TRACK_REDIRECT
+#include "alloc_track.h"
 
-char *
-day2_part1(const char *input, usize input_length)
+// Ids scanned between progress reports and cancellation checks
+#define DAY2_CHECK_INTERVAL (1u << 16)
+
+typedef struct {
+    s64 begin;
+    s64 end;
+} Day2Range;
+
+typedef struct {
+    Day2Range *ranges;
+    usize      count;
+    u64        id_count; // In all ranges, the total to report progress against
+} Day2Input;
+
+static void *
+day2_parse(SolverContext *context, const char *input, usize input_length)
 {
+    UNUSED(context);
+    TRACE_BEGIN("day2_parse");
     StringView sv = sv_from_parts(input, input_length);
     sv = sv_trim(sv);
 
-    u64 invalid_sum = 0;
+    // One range per comma separated part at most
+    usize part_count = 1;
+    for (usize i = 0; i < sv.length; ++i) part_count += sv.begin[i] == ',';
+
+    Day2Input *parsed = (Day2Input *)malloc(sizeof(*parsed));
+    parsed->ranges   = (Day2Range *)malloc(part_count * sizeof(*parsed->ranges));
+    parsed->count    = 0;
+    parsed->id_count = 0;
     while (!sv_is_empty(sv)) {
         StringView range;
         sv_split_first(sv, ',', &range, &sv);
@@ -20,75 +46,142 @@ day2_part1(const char *input, usize input_length)
         StringView end_sv;
         sv_split_first(range, '-', &begin_sv, &end_sv);
 
-        s64 begin;
-        sv_to_int64(begin_sv, &begin);
-        s64 end;
-        sv_to_int64(end_sv, &end);
+        Day2Range *parsed_range = &parsed->ranges[parsed->count++];
+        sv_to_int64(begin_sv, &parsed_range->begin);
+        sv_to_int64(end_sv, &parsed_range->end);
+
+        if (parsed_range->end >= parsed_range->begin) parsed->id_count += (u64)(parsed_range->end - parsed_range->begin) + 1;
+    }
+
+    TRACE_END("day2_parse");
+    return parsed;
+}
+
+static void
+day2_free(void *parsed)
+{
+    Day2Input *day2_input = (Day2Input *)parsed;
+    free(day2_input->ranges);
+    free(day2_input);
+}
+
+static ParsedInputCache day2_inputs = PARSED_INPUT_CACHE(day2_parse, day2_free);
+
+// Part 1's rule, the id is some sequence of digits repeated twice
+static inline bool
+day2_is_doubled(u64 id, u32 digit_count)
+{
+    if ((digit_count & 1) != 0) return false;
+    return u64_high_digits(id, digit_count/2) == u64_low_digits(id, digit_count/2);
+}
+
+// Part 2's rule, the id is some sequence of digits repeated at least twice.
+// A pattern of len digits repeated up to digit_count digits is the pattern
+// times 1, then len - 1 zeros and a 1 again, so the id is divisible by that.
+// The quotient always has len digits, the id has no leading zeros.
+static bool
+day2_is_repeated(u64 id, u32 digit_count)
+{
+    for (u32 len = 1; len <= digit_count/2; ++len) {
+        if ((digit_count % len) != 0) continue;
+        u64 repeat_multiplier = (powers_of_10[digit_count] - 1) / (powers_of_10[len] - 1);
+        if (id % repeat_multiplier == 0) return true;
+    }
+    return false;
+}
+
+char *
+day2_part1(SolverContext *context, const char *input, usize input_length)
+{
+    TRACE_BEGIN("day2_part1");
+    const Day2Input *parsed = (const Day2Input *)parsed_input_acquire(&day2_inputs, context, input, input_length);
+
+    u64 ids_scanned = 0;
+    u64 invalid_sum = 0;
+    for (usize i = 0; i < parsed->count; ++i) {
+        s64 begin = parsed->ranges[i].begin;
+        s64 end   = parsed->ranges[i].end;
 
         for (s64 id_n = begin; id_n <= end; ++id_n) {
-            char *id = sprint("%lld", id_n);
-            if ((strlen(id) & 1) != 0) continue; // Ignore if digit count is odd
-            usize half_len = strlen(id)/2;
-            char *first = id;
-            char *second = id+half_len;
-            if (memcmp(first, second, half_len) == 0) {
-                invalid_sum += id_n;
+            if ((++ids_scanned & (DAY2_CHECK_INTERVAL - 1)) == 0) {
+                solver_report_progress(context, ids_scanned, parsed->id_count);
+                if (solver_cancelled(context)) {
+                    parsed_input_release(&day2_inputs, parsed);
+                    TRACE_END("day2_part1");
+                    return NULL;
+                }
             }
-            free(id);
+            if (day2_is_doubled((u64)id_n, u64_digit_count((u64)id_n))) invalid_sum += id_n;
         }
     }
 
-    return sprint("%lld", invalid_sum);
+    parsed_input_release(&day2_inputs, parsed);
+    TRACE_END("day2_part1");
+    return u64_string(invalid_sum);
 }
 
 char *
-day2_part2(const char *input, usize input_length)
+day2_part2(SolverContext *context, const char *input, usize input_length)
 {
-    StringView sv = sv_from_parts(input, input_length);
-    sv = sv_trim(sv);
+    TRACE_BEGIN("day2_part2");
+    const Day2Input *parsed = (const Day2Input *)parsed_input_acquire(&day2_inputs, context, input, input_length);
 
+    u64 ids_scanned = 0;
     u64 invalid_sum = 0;
-    while (!sv_is_empty(sv)) {
-        StringView range;
-        sv_split_first(sv, ',', &range, &sv);
+    for (usize i = 0; i < parsed->count; ++i) {
+        s64 begin = parsed->ranges[i].begin;
+        s64 end   = parsed->ranges[i].end;
 
-        StringView begin_sv;
-        StringView end_sv;
-        sv_split_first(range, '-', &begin_sv, &end_sv);
+        for (s64 id_n = begin; id_n <= end; ++id_n) {
+            if ((++ids_scanned & (DAY2_CHECK_INTERVAL - 1)) == 0) {
+                solver_report_progress(context, ids_scanned, parsed->id_count);
+                if (solver_cancelled(context)) {
+                    parsed_input_release(&day2_inputs, parsed);
+                    TRACE_END("day2_part2");
+                    return NULL;
+                }
+            }
+            if (day2_is_repeated((u64)id_n, u64_digit_count((u64)id_n))) invalid_sum += id_n;
+        }
+    }
 
-        s64 begin;
-        sv_to_int64(begin_sv, &begin);
-        s64 end;
-        sv_to_int64(end_sv, &end);
+    parsed_input_release(&day2_inputs, parsed);
+    TRACE_END("day2_part2");
+    return u64_string(invalid_sum);
+}
+
+// One scan over the ids, each checked against both rules
+SolverAnswers
+day2_solve_both(SolverContext *context, const char *input, usize input_length)
+{
+    TRACE_BEGIN("day2_solve_both");
+    const Day2Input *parsed = (const Day2Input *)parsed_input_acquire(&day2_inputs, context, input, input_length);
+
+    u64 ids_scanned = 0;
+    u64 twice_sum   = 0;
+    u64 repeat_sum  = 0;
+    for (usize i = 0; i < parsed->count; ++i) {
+        s64 begin = parsed->ranges[i].begin;
+        s64 end   = parsed->ranges[i].end;
 
         for (s64 id_n = begin; id_n <= end; ++id_n) {
-            char *id = sprint("%lld", id_n);
-            usize id_len = strlen(id);
-            usize half_id_len = id_len/2;
-
-            bool id_invalid = false;
-            for (size_t len = 1; len <= half_id_len; ++len) {
-                if ((id_len % len) != 0) continue;
-                StringView sub_id = sv_from_parts(id, len);
-                if (sub_id.begin[0] == '0') continue;
-
-                bool sub_invalid = true;
-                usize next_begin = len;
-                while (next_begin < id_len) {
-                    StringView comp_id = sv_from_parts(id+next_begin, len);
-                    if (!sv_eq(sub_id, comp_id)) {
-                        sub_invalid = false;
-                        break;
-                    }
-                    next_begin += len;
+            if ((++ids_scanned & (DAY2_CHECK_INTERVAL - 1)) == 0) {
+                solver_report_progress(context, ids_scanned, parsed->id_count);
+                if (solver_cancelled(context)) {
+                    parsed_input_release(&day2_inputs, parsed);
+                    TRACE_END("day2_solve_both");
+                    return (SolverAnswers){0};
                 }
-                if (sub_invalid) id_invalid = true;
             }
-            if (id_invalid) invalid_sum += id_n;
-
-            free(id);
+            u32 digit_count = u64_digit_count((u64)id_n);
+            if (day2_is_doubled((u64)id_n, digit_count)) twice_sum += id_n;
+            if (day2_is_repeated((u64)id_n, digit_count)) repeat_sum += id_n;
         }
     }
 
-    return sprint("%lld", invalid_sum);
+    parsed_input_release(&day2_inputs, parsed);
+    SolverAnswers answers = {u64_string(twice_sum), u64_string(repeat_sum)};
+
+    TRACE_END("day2_solve_both");
+    return answers;
 }
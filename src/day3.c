@@ -1,29 +1,120 @@
 #include "days.h"
 #include "basic.h"
+#include "trace.h"
+#include "parsed_input.h"
+#include "parallel_lines.h"
 
 #include "sv.h"
 
 #include <string.h>
 
-char *
-day3_part1(const char *input, usize input_length)
+#define ALLOC_TRACK_REDIRECT
+#include "alloc_track.h"
+
+#define DAY3_PARSE_GRAIN_SIZE (64*1024)
+
+typedef struct {
+    u8    *digits;       // 0 to 9, one bank after the other
+    usize *bank_offsets; // bank_count + 1 of them, bank i is digits[bank_offsets[i]] up to bank_offsets[i + 1]
+    usize  bank_count;
+} Day3Input;
+
+// Banks of one chunk of lines, see parallel_lines.h
+typedef struct {
+    u8    *digits;
+    usize *bank_lengths;
+    usize  digit_count;
+    usize  bank_count;
+} Day3Chunk;
+
+static void
+day3_parse_lines(StringView lines, void *state, void *user_data)
 {
-    s64 globally_total_joltage = 0;
+    UNUSED(user_data);
+    Day3Chunk *chunk = (Day3Chunk *)state;
 
-    StringView sv = sv_from_parts(input, input_length);
-    sv = sv_trim(sv);
-    while (!sv_is_empty(sv)) {
+    usize line_count = 1;
+    for (usize i = 0; i < lines.length; ++i) line_count += lines.begin[i] == '\n';
+
+    chunk->digits       = (u8 *)malloc(lines.length + 1);
+    chunk->bank_lengths = (usize *)malloc(line_count * sizeof(*chunk->bank_lengths));
+    while (!sv_is_empty(lines)) {
         StringView bank;
-        sv_split_first(sv, '\n', &bank, &sv);
+        sv_split_first(lines, '\n', &bank, &lines);
         bank = sv_trim(bank);
+        if (bank.length == 0) continue;
+
+        for (usize i = 0; i < bank.length; ++i) chunk->digits[chunk->digit_count++] = (u8)(sv_at(bank, i) - '0');
+        chunk->bank_lengths[chunk->bank_count++] = bank.length;
+    }
+}
+
+static void
+day3_append_banks(void *result, void *state, void *user_data)
+{
+    UNUSED(user_data);
+    Day3Input *parsed = (Day3Input *)result;
+    Day3Chunk *chunk  = (Day3Chunk *)state;
+
+    usize digit_count = parsed->bank_offsets[parsed->bank_count];
+    memcpy(parsed->digits + digit_count, chunk->digits, chunk->digit_count);
+    for (usize i = 0; i < chunk->bank_count; ++i) {
+        digit_count += chunk->bank_lengths[i];
+        parsed->bank_offsets[++parsed->bank_count] = digit_count;
+    }
+    free(chunk->digits);
+    free(chunk->bank_lengths);
+}
+
+static void *
+day3_parse(SolverContext *context, const char *input, usize input_length)
+{
+    TRACE_BEGIN("day3_parse");
+    StringView sv = sv_from_parts(input, input_length);
+    sv = sv_trim(sv);
+
+    usize line_count = 1;
+    for (usize i = 0; i < sv.length; ++i) line_count += sv.begin[i] == '\n';
+
+    Day3Input *parsed    = (Day3Input *)malloc(sizeof(*parsed));
+    parsed->digits       = (u8 *)malloc(sv.length + 1);
+    parsed->bank_offsets = (usize *)malloc((line_count + 1) * sizeof(*parsed->bank_offsets));
+    parsed->bank_count   = 0;
+
+    parsed->bank_offsets[0] = 0;
+    parallel_reduce_lines(context->pool, sv, DAY3_PARSE_GRAIN_SIZE, sizeof(Day3Chunk),
+                          day3_parse_lines, day3_append_banks, parsed, NULL);
+
+    TRACE_END("day3_parse");
+    return parsed;
+}
+
+static void
+day3_free(void *parsed)
+{
+    Day3Input *day3_input = (Day3Input *)parsed;
+    free(day3_input->digits);
+    free(day3_input->bank_offsets);
+    free(day3_input);
+}
+
+static ParsedInputCache day3_inputs = PARSED_INPUT_CACHE(day3_parse, day3_free);
+
+char *
+day3_part1(SolverContext *context, const char *input, usize input_length)
+{
+    TRACE_BEGIN("day3_part1");
+    const Day3Input *parsed = (const Day3Input *)parsed_input_acquire(&day3_inputs, context, input, input_length);
+    s64 globally_total_joltage = 0;
+
+    for (usize b = 0; b < parsed->bank_count; ++b) {
+        const u8 *bank        = parsed->digits + parsed->bank_offsets[b];
+        usize     bank_length = parsed->bank_offsets[b + 1] - parsed->bank_offsets[b];
 
         s64 max_joltage_in_bank = 0;
-        for (usize i = 0; i < bank.length - 1; ++i) {
-            for (usize j = i+1; j < bank.length; ++j) {
-                char joltage_cstr[2] = {sv_at(bank, i), sv_at(bank, j)};
-                StringView joltage_sv = sv_from_parts(joltage_cstr, 2);
-                s64 joltage;
-                sv_to_int64(joltage_sv, &joltage);
+        for (usize i = 0; i < bank_length - 1; ++i) {
+            for (usize j = i+1; j < bank_length; ++j) {
+                s64 joltage = 10*bank[i] + bank[j];
                 max_joltage_in_bank = max_s64(max_joltage_in_bank,
                                               joltage);
             }
@@ -31,49 +122,106 @@ day3_part1(const char *input, usize input_length)
         globally_total_joltage += max_joltage_in_bank;
     }
 
-    return sprint("%lld", globally_total_joltage);
+    parsed_input_release(&day3_inputs, parsed);
+    TRACE_END("day3_part1");
+    return s64_string(globally_total_joltage);
 }
 
 char *
-day3_part2(const char *input, usize input_length)
+day3_part2(SolverContext *context, const char *input, usize input_length)
 {
+    TRACE_BEGIN("day3_part2");
+    const Day3Input *parsed = (const Day3Input *)parsed_input_acquire(&day3_inputs, context, input, input_length);
     s64 globally_total_joltage = 0;
 
-    StringView sv = sv_from_parts(input, input_length);
-    sv = sv_trim(sv);
-    while (!sv_is_empty(sv)) {
-        StringView bank;
-        sv_split_first(sv, '\n', &bank, &sv);
-        bank = sv_trim(bank);
-        if (bank.length == 0) break;
+    for (usize b = 0; b < parsed->bank_count; ++b) {
+        const u8 *bank        = parsed->digits + parsed->bank_offsets[b];
+        usize     bank_length = parsed->bank_offsets[b + 1] - parsed->bank_offsets[b];
 
-        char max_joltage_in_bank_buffer[12] = {0};
+        s64 max_joltage_in_bank = 0;
         usize filled = 0;
         usize start = 0;
         while (filled < 12) {
             usize left = 12 - filled;
-            usize end = bank.length - left + 1;
+            usize end = bank_length - left + 1;
 
             s32 best_digit = -1;
             usize best_index = start;
 
             for (usize i = start; i < end; ++i) {
-                s32 digit = sv_at(bank, i) - '0';
+                s32 digit = bank[i];
                 if (digit > best_digit) {
                     best_digit = digit;
                     best_index = i;
                 }
             }
 
-            max_joltage_in_bank_buffer[filled++] = (char)(best_digit + '0');
+            max_joltage_in_bank = 10*max_joltage_in_bank + best_digit;
+            filled += 1;
             start = best_index + 1;
         }
 
-        StringView max_joltage_in_bank_sv = sv_from_parts(max_joltage_in_bank_buffer, 12);
-        s64 max_joltage_in_bank;
-        sv_to_int64(max_joltage_in_bank_sv, &max_joltage_in_bank);
         globally_total_joltage += max_joltage_in_bank;
     }
 
-    return sprint("%lld", globally_total_joltage);
+    parsed_input_release(&day3_inputs, parsed);
+    TRACE_END("day3_part2");
+    return s64_string(globally_total_joltage);
+}
+
+// Largest number made of count digits of the bank, in their order in the bank.
+// Kept as a stack while going over the bank once: a digit replaces the
+// smaller ones before it while enough digits remain to fill the rest.
+typedef struct {
+    u8    digits[12];
+    usize count;
+    usize filled;
+} Day3Selection;
+
+static inline void
+day3_select(Day3Selection *selection, u8 digit, usize digits_left)
+{
+    while (selection->filled > 0 && selection->digits[selection->filled - 1] < digit &&
+           selection->filled - 1 + digits_left >= selection->count) {
+        selection->filled -= 1;
+    }
+    if (selection->filled < selection->count) selection->digits[selection->filled++] = digit;
+}
+
+static inline s64
+day3_selection_value(const Day3Selection *selection)
+{
+    s64 value = 0;
+    for (usize i = 0; i < selection->filled; ++i) value = 10*value + selection->digits[i];
+    return value;
+}
+
+// Picks the two and the twelve digits in the same pass over each bank
+SolverAnswers
+day3_solve_both(SolverContext *context, const char *input, usize input_length)
+{
+    TRACE_BEGIN("day3_solve_both");
+    const Day3Input *parsed = (const Day3Input *)parsed_input_acquire(&day3_inputs, context, input, input_length);
+    s64 pairs_total  = 0;
+    s64 twelve_total = 0;
+
+    for (usize b = 0; b < parsed->bank_count; ++b) {
+        const u8 *bank        = parsed->digits + parsed->bank_offsets[b];
+        usize     bank_length = parsed->bank_offsets[b + 1] - parsed->bank_offsets[b];
+
+        Day3Selection pair   = {.count = 2};
+        Day3Selection twelve = {.count = 12};
+        for (usize i = 0; i < bank_length; ++i) {
+            day3_select(&pair,   bank[i], bank_length - i);
+            day3_select(&twelve, bank[i], bank_length - i);
+        }
+        pairs_total  += day3_selection_value(&pair);
+        twelve_total += day3_selection_value(&twelve);
+    }
+
+    parsed_input_release(&day3_inputs, parsed);
+    SolverAnswers answers = {s64_string(pairs_total), s64_string(twelve_total)};
+
+    TRACE_END("day3_solve_both");
+    return answers;
 }
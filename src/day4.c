@@ -1,107 +1,214 @@
 #include "days.h"
 #include "basic.h"
+#include "trace.h"
+#include "parsed_input.h"
 
 #include "sv.h"
 
 #include <stdint.h>
 #include <string.h>
 
-char *
-day4_part1(const char *input, usize input_length)
+#define ALLOC_TRACK_REDIRECT
+#include "alloc_track.h"
+
+static GridFrames *volatile day4_grid_frames = NULL;
+
+void
+day4_set_grid_frames(GridFrames *frames)
 {
-    StringView sv = sv_from_parts(input, input_length);
+    day4_grid_frames = frames;
+}
 
-    intptr_t grid_width = 0;
-    while (sv_at(sv, grid_width) != '\n') grid_width += 1;
-    intptr_t grid_pitch = grid_width + 1;
+typedef struct {
+    u8   *cells;      // 1 for a roll of paper, row by row, with a border of empty cells around the grid
+    u32   width;      // Of the grid, without the border
+    u32   height;
+    usize pitch;      // width + 2
+    u64   roll_count;
+} Day4Input;
 
-    s64 accessible = 0;
+static void *
+day4_parse(SolverContext *context, const char *input, usize input_length)
+{
+    UNUSED(context);
+    TRACE_BEGIN("day4_parse");
+    StringView sv = sv_from_parts(input, input_length);
 
-    for (intptr_t current_index = 0; current_index < (intptr_t)sv.length; ++current_index) {
-        if (sv_at(sv, current_index) != '@') continue;
-
-        s32 adjacent_rolls_of_paper = 0;
-
-        intptr_t left_index        = current_index - 1;
-        intptr_t right_index       = current_index + 1;
-        intptr_t above_index       = current_index - grid_pitch;
-        intptr_t below_index       = current_index + grid_pitch;
-        intptr_t above_left_index  = above_index - 1;
-        intptr_t above_right_index = above_index + 1;
-        intptr_t below_left_index  = below_index - 1;
-        intptr_t below_right_index = below_index + 1;
-        if ((left_index        >= 0) && (left_index        < (intptr_t)sv.length) && (sv_at(sv, left_index)        == '@')) adjacent_rolls_of_paper += 1;
-        if ((right_index       >= 0) && (right_index       < (intptr_t)sv.length) && (sv_at(sv, right_index)       == '@')) adjacent_rolls_of_paper += 1;
-        if ((above_index       >= 0) && (above_index       < (intptr_t)sv.length) && (sv_at(sv, above_index)       == '@')) adjacent_rolls_of_paper += 1;
-        if ((below_index       >= 0) && (below_index       < (intptr_t)sv.length) && (sv_at(sv, below_index)       == '@')) adjacent_rolls_of_paper += 1;
-        if ((above_left_index  >= 0) && (above_left_index  < (intptr_t)sv.length) && (sv_at(sv, above_left_index)  == '@')) adjacent_rolls_of_paper += 1;
-        if ((above_right_index >= 0) && (above_right_index < (intptr_t)sv.length) && (sv_at(sv, above_right_index) == '@')) adjacent_rolls_of_paper += 1;
-        if ((below_left_index  >= 0) && (below_left_index  < (intptr_t)sv.length) && (sv_at(sv, below_left_index)  == '@')) adjacent_rolls_of_paper += 1;
-        if ((below_right_index >= 0) && (below_right_index < (intptr_t)sv.length) && (sv_at(sv, below_right_index) == '@')) adjacent_rolls_of_paper += 1;
-
-        if (adjacent_rolls_of_paper >= 4) continue;
-
-        accessible += 1;
+    usize width = 0;
+    while (width < sv.length && sv_at(sv, width) != '\n') width += 1;
+    usize height = 0;
+    for (usize i = 0; i < sv.length; i += width + 1) height += 1;
+
+    Day4Input *parsed  = (Day4Input *)malloc(sizeof(*parsed));
+    parsed->width      = (u32)width;
+    parsed->height     = (u32)height;
+    parsed->pitch      = width + 2;
+    parsed->cells      = (u8 *)calloc((height + 2) * parsed->pitch, 1);
+    parsed->roll_count = 0;
+    for (usize y = 0; y < height; ++y) {
+        // The last row may miss its newline, or be cut short
+        usize       row_start = y*(width + 1);
+        usize       row_size  = row_start + width <= input_length ? width : input_length - row_start;
+        const char *row       = input + row_start;
+        u8         *cell_row  = parsed->cells + (y + 1)*parsed->pitch + 1;
+        for (usize x = 0; x < row_size; ++x) {
+            cell_row[x]         = row[x] == '@';
+            parsed->roll_count += cell_row[x];
+        }
     }
 
-    return sprint("%lld", accessible);
+    TRACE_END("day4_parse");
+    return parsed;
+}
+
+static void
+day4_free(void *parsed)
+{
+    Day4Input *day4_input = (Day4Input *)parsed;
+    free(day4_input->cells);
+    free(day4_input);
+}
+
+static ParsedInputCache day4_inputs = PARSED_INPUT_CACHE(day4_parse, day4_free);
+
+static inline u32
+day4_adjacent_rolls(const u8 *cell, usize pitch)
+{
+    return cell[-(intptr_t)pitch - 1] + cell[-(intptr_t)pitch] + cell[-(intptr_t)pitch + 1] +
+           cell[-1]                                            + cell[1] +
+           cell[pitch - 1]            + cell[pitch]            + cell[pitch + 1];
+}
+
+// current is the grid after the round, previous the one before it, both as Day4Input cells
+static void
+day4_publish_round(GridFrames *frames, const u8 *current, const u8 *previous, usize pitch, u32 round)
+{
+    TRACE_BEGIN("day4_publish_round");
+    u8 *cells = grid_frames_write_buffer(frames);
+    for (u32 y = 0; y < frames->height; ++y) {
+        const u8 *current_row  = current  + (y + 1)*pitch + 1;
+        const u8 *previous_row = previous + (y + 1)*pitch + 1;
+        u8       *cell_row     = cells    + (usize)y*frames->width;
+        for (u32 x = 0; x < frames->width; ++x) {
+            if      (current_row[x])  cell_row[x] = 255;
+            else if (previous_row[x]) cell_row[x] = 96;
+            else                      cell_row[x] = 0;
+        }
+    }
+    grid_frames_publish(frames, round);
+    TRACE_END("day4_publish_round");
 }
 
 char *
-day4_part2(const char *input, usize input_length)
+day4_part1(SolverContext *context, const char *input, usize input_length)
 {
-    StringView sv = sv_from_parts(input, input_length);
+    TRACE_BEGIN("day4_part1");
+    const Day4Input *parsed = (const Day4Input *)parsed_input_acquire(&day4_inputs, context, input, input_length);
+
+    s64 accessible = 0;
+    for (usize y = 0; y < parsed->height; ++y) {
+        const u8 *row = parsed->cells + (y + 1)*parsed->pitch + 1;
+        for (usize x = 0; x < parsed->width; ++x) {
+            if (!row[x]) continue;
+            if (day4_adjacent_rolls(&row[x], parsed->pitch) >= 4) continue;
+            accessible += 1;
+        }
+    }
+
+    parsed_input_release(&day4_inputs, parsed);
+    TRACE_END("day4_part1");
+    return s64_string(accessible);
+}
 
-    char *backbuf = (char *)malloc(input_length);
-    char *to_free = backbuf;
+// Removes accessible rolls round after round until none are left, into
+// removable. The first round removes exactly the rolls part 1 counts, those
+// go into first_round. Returns false if cancelled.
+static bool
+day4_remove_rolls(SolverContext *context, const char *input, usize input_length, s64 *removable_out, s64 *first_round)
+{
+    const Day4Input *parsed = (const Day4Input *)parsed_input_acquire(&day4_inputs, context, input, input_length);
+    usize pitch      = parsed->pitch;
+    usize cells_size = (parsed->height + 2)*pitch;
+
+    // Both buffers are private, the parsed input is shared with part 1
+    u8 *frontbuf = (u8 *)malloc(2*cells_size);
+    u8 *backbuf  = frontbuf + cells_size;
+    u8 *to_free  = frontbuf;
+    memcpy(frontbuf, parsed->cells, cells_size);
+
+    // Only publish when the frames are of this grid
+    GridFrames *frames = day4_grid_frames;
+    if (frames && (frames->input != input || frames->width != parsed->width || frames->height != parsed->height)) {
+        frames = NULL;
+    }
+    u32 round = 0;
+    if (frames) day4_publish_round(frames, frontbuf, frontbuf, pitch, round);
 
-    intptr_t grid_width = 0;
-    while (sv_at(sv, grid_width) != '\n') grid_width += 1;
-    intptr_t grid_pitch = grid_width + 1;
+    // Progress is the share of rolls removed so far, most inputs keep some
+    u64 roll_count = parsed->roll_count;
 
     s64 removable = 0;
     s64 removable_before = -1;
+    bool cancelled = false;
     while (removable != removable_before) {
+        if (solver_cancelled(context)) {
+            cancelled = true;
+            break;
+        }
+        TRACE_BEGIN("day4_part2: round");
         removable_before = removable;
-        memcpy(backbuf, sv.begin, sv.length);
+        memcpy(backbuf, frontbuf, cells_size);
 
         s64 accessible = 0;
-        for (intptr_t current_index = 0; current_index < (intptr_t)sv.length; ++current_index) {
-            if (sv_at(sv, current_index) != '@') continue;
-
-            s32 adjacent_rolls_of_paper = 0;
-
-            intptr_t left_index        = current_index - 1;
-            intptr_t right_index       = current_index + 1;
-            intptr_t above_index       = current_index - grid_pitch;
-            intptr_t below_index       = current_index + grid_pitch;
-            intptr_t above_left_index  = above_index - 1;
-            intptr_t above_right_index = above_index + 1;
-            intptr_t below_left_index  = below_index - 1;
-            intptr_t below_right_index = below_index + 1;
-            if ((left_index        >= 0) && (left_index        < (intptr_t)sv.length) && (sv_at(sv, left_index)        == '@')) adjacent_rolls_of_paper += 1;
-            if ((right_index       >= 0) && (right_index       < (intptr_t)sv.length) && (sv_at(sv, right_index)       == '@')) adjacent_rolls_of_paper += 1;
-            if ((above_index       >= 0) && (above_index       < (intptr_t)sv.length) && (sv_at(sv, above_index)       == '@')) adjacent_rolls_of_paper += 1;
-            if ((below_index       >= 0) && (below_index       < (intptr_t)sv.length) && (sv_at(sv, below_index)       == '@')) adjacent_rolls_of_paper += 1;
-            if ((above_left_index  >= 0) && (above_left_index  < (intptr_t)sv.length) && (sv_at(sv, above_left_index)  == '@')) adjacent_rolls_of_paper += 1;
-            if ((above_right_index >= 0) && (above_right_index < (intptr_t)sv.length) && (sv_at(sv, above_right_index) == '@')) adjacent_rolls_of_paper += 1;
-            if ((below_left_index  >= 0) && (below_left_index  < (intptr_t)sv.length) && (sv_at(sv, below_left_index)  == '@')) adjacent_rolls_of_paper += 1;
-            if ((below_right_index >= 0) && (below_right_index < (intptr_t)sv.length) && (sv_at(sv, below_right_index) == '@')) adjacent_rolls_of_paper += 1;
-
-            if (adjacent_rolls_of_paper >= 4) continue;
-
-            accessible += 1;
-            backbuf[current_index] = '.';
+        for (usize y = 0; y < parsed->height; ++y) {
+            usize     row_index = (y + 1)*pitch + 1;
+            const u8 *row       = frontbuf + row_index;
+            for (usize x = 0; x < parsed->width; ++x) {
+                if (!row[x]) continue;
+                if (day4_adjacent_rolls(&row[x], pitch) >= 4) continue;
+                accessible += 1;
+                backbuf[row_index + x] = 0;
+            }
         }
 
+        if (removable == 0) *first_round = accessible;
         removable += accessible;
+        solver_report_progress(context, (u64)removable, roll_count);
 
         // Swap buffers
-        char *temp = (char *)sv.begin;
-        sv.begin = backbuf;
-        backbuf = temp;
+        u8 *temp = frontbuf;
+        frontbuf = backbuf;
+        backbuf  = temp;
+        if (frames && accessible > 0) day4_publish_round(frames, frontbuf, backbuf, pitch, ++round);
+        TRACE_END("day4_part2: round");
     }
 
     free(to_free);
-    return sprint("%lld", removable);
+    parsed_input_release(&day4_inputs, parsed);
+    *removable_out = removable;
+    return !cancelled;
+}
+
+char *
+day4_part2(SolverContext *context, const char *input, usize input_length)
+{
+    TRACE_BEGIN("day4_part2");
+    s64  removable   = 0;
+    s64  first_round = 0;
+    bool finished    = day4_remove_rolls(context, input, input_length, &removable, &first_round);
+    TRACE_END("day4_part2");
+    if (!finished) return NULL;
+    return s64_string(removable);
+}
+
+SolverAnswers
+day4_solve_both(SolverContext *context, const char *input, usize input_length)
+{
+    TRACE_BEGIN("day4_solve_both");
+    s64  removable   = 0;
+    s64  first_round = 0;
+    bool finished    = day4_remove_rolls(context, input, input_length, &removable, &first_round);
+    TRACE_END("day4_solve_both");
+    if (!finished) return (SolverAnswers){0};
+    return (SolverAnswers){s64_string(first_round), s64_string(removable)};
 }
@@ -1,70 +1,173 @@
 #include "basic.h"
 #include "days.h"
+#include "trace.h"
+#include "parsed_input.h"
+#include "parallel_lines.h"
+#include "containers.h"
 
 #include "sv.h"
-#include "stb_ds.h"
 
 #include <stdint.h>
 #include <string.h>
 
+#define ALLOC_TRACK_REDIRECT
+#include "alloc_track.h"
+
+#define DAY5_PARSE_GRAIN_SIZE (64*1024)
+
+// Structure of arrays, range i is range_begins.items[i] up to and including
+// range_ends.items[i]
 typedef struct {
-    s64 begin;
-    s64 end;
-} Range;
+    S64Vec range_begins;
+    S64Vec range_ends;
+    S64Vec available_ingredients_ids;
+} Day5Input;
 
-char *
-day5_part1(const char *input, usize input_length)
+// Chunks of lines parse into vectors of their own, see parallel_lines.h
+typedef struct {
+    S64Vec begins;
+    S64Vec ends;
+} Day5Ranges;
+
+static void
+day5_parse_ranges(StringView lines, void *state, void *user_data)
+{
+    UNUSED(user_data);
+    Day5Ranges *ranges = (Day5Ranges *)state;
+    while (!sv_is_empty(lines)) {
+        StringView range_sv;
+        sv_split_first(lines, '\n', &range_sv, &lines);
+        range_sv = sv_trim(range_sv);
+        if (sv_is_empty(range_sv)) continue;
+
+        StringView range_begin_sv;
+        StringView range_end_sv;
+        sv_split_first(range_sv, '-', &range_begin_sv, &range_end_sv);
+        s64 begin, end;
+        sv_to_int64(range_begin_sv, &begin);
+        sv_to_int64(range_end_sv, &end);
+        vec_push(&ranges->begins, begin);
+        vec_push(&ranges->ends, end);
+    }
+}
+
+// Appends chunk to vec, or hands chunk over if vec is still empty
+static void
+day5_append_s64s(S64Vec *vec, S64Vec *chunk)
+{
+    if (!vec->items) {
+        *vec = *chunk;
+        return;
+    }
+    if (chunk->count) vec_push_many(vec, chunk->items, chunk->count);
+    vec_free(chunk);
+}
+
+static void
+day5_append_ranges(void *result, void *state, void *user_data)
+{
+    UNUSED(user_data);
+    Day5Input  *parsed = (Day5Input *)result;
+    Day5Ranges *chunk  = (Day5Ranges *)state;
+    day5_append_s64s(&parsed->range_begins, &chunk->begins);
+    day5_append_s64s(&parsed->range_ends, &chunk->ends);
+}
+
+static void
+day5_parse_ids(StringView lines, void *state, void *user_data)
+{
+    UNUSED(user_data);
+    S64Vec *ids = (S64Vec *)state;
+    while (!sv_is_empty(lines)) {
+        StringView id_sv;
+        sv_split_first(lines, '\n', &id_sv, &lines);
+        id_sv = sv_trim(id_sv);
+        if (sv_is_empty(id_sv)) continue;
+
+        s64 id;
+        sv_to_int64(id_sv, &id);
+        vec_push(ids, id);
+    }
+}
+
+static void
+day5_append_ids(void *result, void *state, void *user_data)
+{
+    UNUSED(user_data);
+    day5_append_s64s((S64Vec *)result, (S64Vec *)state);
+}
+
+static void *
+day5_parse(SolverContext *context, const char *input, usize input_length)
 {
     // Split input up into one view of ranges, and one view of available ingredients
     StringView temp = sv_from_parts(input, input_length);
-    while (sv_first(temp) != '\n') {
+    while (!sv_is_empty(temp) && sv_first(temp) != '\n') {
         sv_split_first(temp, '\n', NULL, &temp);
     }
     StringView fresh_id_ranges_sv = sv_from_parts(input, temp.begin - input);
     fresh_id_ranges_sv = sv_trim(fresh_id_ranges_sv);
-    StringView available_ingredients_ids_sv = sv_from_parts(temp.begin, temp.length-1);
+    StringView available_ingredients_ids_sv = sv_from_parts(temp.begin, temp.length ? temp.length-1 : 0);
     available_ingredients_ids_sv = sv_trim(available_ingredients_ids_sv);
 
+    Day5Input *parsed = (Day5Input *)calloc(1, sizeof(*parsed));
 
     // Build array of ranges of fresh ingredient IDs
-    Range *fresh_id_ranges = NULL;
-    temp = fresh_id_ranges_sv;
-    while (!sv_is_empty(temp)) {
-        StringView range_sv;
-        sv_split_first(temp, '\n', &range_sv, &temp);
-        StringView range_begin_sv;
-        StringView range_end_sv;
-        sv_split_first(range_sv, '-', &range_begin_sv, &range_end_sv);
-        Range range;
-        sv_to_int64(range_begin_sv, &range.begin);
-        sv_to_int64(range_end_sv, &range.end);
-        arrput(fresh_id_ranges, range);
-    }
+    TRACE_BEGIN("day5_parse: ranges");
+    parallel_reduce_lines(context->pool, fresh_id_ranges_sv, DAY5_PARSE_GRAIN_SIZE, sizeof(Day5Ranges),
+                          day5_parse_ranges, day5_append_ranges, parsed, NULL);
+    TRACE_END("day5_parse: ranges");
+
+    TRACE_BEGIN("day5_parse: ingredients");
+    parallel_reduce_lines(context->pool, available_ingredients_ids_sv, DAY5_PARSE_GRAIN_SIZE, sizeof(S64Vec),
+                          day5_parse_ids, day5_append_ids, &parsed->available_ingredients_ids, NULL);
+    TRACE_END("day5_parse: ingredients");
+
+    return parsed;
+}
+
+static void
+day5_free(void *parsed)
+{
+    Day5Input *day5_input = (Day5Input *)parsed;
+    vec_free(&day5_input->range_begins);
+    vec_free(&day5_input->range_ends);
+    vec_free(&day5_input->available_ingredients_ids);
+    free(day5_input);
+}
+
+static ParsedInputCache day5_inputs = PARSED_INPUT_CACHE(day5_parse, day5_free);
+
+char *
+day5_part1(SolverContext *context, const char *input, usize input_length)
+{
+    const Day5Input *parsed = (const Day5Input *)parsed_input_acquire(&day5_inputs, context, input, input_length);
 
     // Count available ingredient IDs that are within fresh ranges
+    TRACE_BEGIN("day5_part1: count fresh");
     s64 n_fresh_available_ingredients_ids = 0;
-    temp = available_ingredients_ids_sv;
-    while (!sv_is_empty(temp)) {
-        StringView id_sv;
-        sv_split_first(temp, '\n', &id_sv, &temp);
-        s64 id;
-        sv_to_int64(id_sv, &id);
+    const s64 *begins = parsed->range_begins.items;
+    const s64 *ends   = parsed->range_ends.items;
+    for (usize i = 0; i < parsed->available_ingredients_ids.count; ++i) {
+        s64 id = parsed->available_ingredients_ids.items[i];
 
-        for (usize i = 0; i < arrlenu(fresh_id_ranges); ++i) {
-            Range *range = &fresh_id_ranges[i];
-            if (id >= range->begin && id <= range->end) {
+        for (usize j = 0; j < parsed->range_begins.count; ++j) {
+            if (id >= begins[j] && id <= ends[j]) {
                 n_fresh_available_ingredients_ids += 1;
                 break;
             }
         }
     }
 
-    arrfree(fresh_id_ranges);
-    return sprint("%lld", n_fresh_available_ingredients_ids);
+    TRACE_END("day5_part1: count fresh");
+
+    parsed_input_release(&day5_inputs, parsed);
+    return s64_string(n_fresh_available_ingredients_ids);
 }
 
 char *
-day5_part2(const char *input, usize input_length)
+day5_part2(SolverContext *context, const char *input, usize input_length)
 {
-    return sprint("");
+    UNUSED(context);
+    return (char *)calloc(1, 1); // Not solved yet, an empty answer
 }
@@ -0,0 +1,126 @@
+#include "days.h"
+#include "parsed_input.h"
+
+#include "solver_build_id.h"
+
+#include <string.h>
+
+u64
+solver_build_id(void)
+{
+    return AOC2025_SOLVER_BUILD_ID;
+}
+
+// Every level's build of the day sources, suffixed as in bs.c
+#define DECLARE_PROBLEM(name, suffix) char *name##suffix(SolverContext *context, const char *input, usize input_length);
+#define DECLARE_BOTH(name, suffix) SolverAnswers name##suffix(SolverContext *context, const char *input, usize input_length);
+#define DECLARE_LEVEL(suffix)                \
+    SOLVER_PROBLEMS(DECLARE_PROBLEM, suffix) \
+    SOLVER_BOTH(DECLARE_BOTH, suffix)        \
+    void day4_set_grid_frames##suffix(GridFrames *frames);
+
+DECLARE_LEVEL(_baseline)
+DECLARE_LEVEL(_sse42)
+DECLARE_LEVEL(_avx2)
+DECLARE_LEVEL(_avx512)
+
+#define PROBLEM_INDEX(name, unused) PROBLEM_##name,
+enum { SOLVER_PROBLEMS(PROBLEM_INDEX, _) PROBLEM_COUNT };
+#define BOTH_INDEX(name, unused) BOTH_##name,
+enum { SOLVER_BOTH(BOTH_INDEX, _) BOTH_COUNT };
+
+typedef struct {
+    ProblemFunc   problems[PROBLEM_COUNT];
+    SolveBothFunc both[BOTH_COUNT];
+    void (*set_grid_frames)(GridFrames *frames);
+} SolverLevel;
+
+#define LEVEL_PROBLEM(name, suffix) name##suffix,
+#define LEVEL(suffix) {{SOLVER_PROBLEMS(LEVEL_PROBLEM, suffix)}, {SOLVER_BOTH(LEVEL_PROBLEM, suffix)}, day4_set_grid_frames##suffix}
+
+static const SolverLevel solver_levels[ISA_COUNT] = {
+    [ISA_BASELINE] = LEVEL(_baseline),
+    [ISA_SSE42]    = LEVEL(_sse42),
+    [ISA_AVX2]     = LEVEL(_avx2),
+    [ISA_AVX512]   = LEVEL(_avx512),
+};
+
+static volatile u32 solver_isa = ISA_COUNT; // Until the first solver or solvers_set_isa()
+
+bool
+solvers_set_isa(Isa isa)
+{
+    Isa supported = cpu_isa();
+    if (isa == ISA_AUTO) isa = supported;
+    if (isa < 0 || isa >= ISA_COUNT || isa > supported) return false;
+    atomic_store_u32(&solver_isa, (u32)isa);
+    return true;
+}
+
+Isa
+solvers_isa(void)
+{
+    if (atomic_load_u32(&solver_isa) == ISA_COUNT) solvers_set_isa(ISA_AUTO);
+    return (Isa)atomic_load_u32(&solver_isa);
+}
+
+// The caches of all levels' day sources share parsed_input.c's list
+void
+solvers_flush_parsed_inputs(void)
+{
+    parsed_input_flush_all();
+}
+
+#define DEFINE_PROBLEM(name, unused)                                                      \
+    char *                                                                                \
+    name(SolverContext *context, const char *input, usize input_length)                   \
+    {                                                                                     \
+        const SolverLevel *level = &solver_levels[solvers_isa()];                         \
+        return level->problems[PROBLEM_##name](context, input, input_length);             \
+    }
+
+SOLVER_PROBLEMS(DEFINE_PROBLEM, _)
+
+#define DEFINE_BOTH(name, unused)                                                         \
+    SolverAnswers                                                                         \
+    name(SolverContext *context, const char *input, usize input_length)                   \
+    {                                                                                     \
+        const SolverLevel *level = &solver_levels[solvers_isa()];                         \
+        return level->both[BOTH_##name](context, input, input_length);                    \
+    }
+
+SOLVER_BOTH(DEFINE_BOTH, _)
+
+#define PROBLEM_NAME(name, unused) #name,
+static const char *problem_names[PROBLEM_COUNT] = { SOLVER_PROBLEMS(PROBLEM_NAME, _) };
+
+#define PROBLEM_FUNC(name, unused) name,
+static const ProblemFunc problem_funcs[PROBLEM_COUNT] = { SOLVER_PROBLEMS(PROBLEM_FUNC, _) };
+
+ProblemFunc
+solver_find(const char *name)
+{
+    for (usize i = 0; i < PROBLEM_COUNT; ++i) {
+        if (strcmp(problem_names[i], name) == 0) return problem_funcs[i];
+    }
+    return NULL;
+}
+
+static const char *both_names[BOTH_COUNT] = { SOLVER_BOTH(PROBLEM_NAME, _) };
+static const SolveBothFunc both_funcs[BOTH_COUNT] = { SOLVER_BOTH(PROBLEM_FUNC, _) };
+
+SolveBothFunc
+solver_find_both(const char *name)
+{
+    for (usize i = 0; i < BOTH_COUNT; ++i) {
+        if (strcmp(both_names[i], name) == 0) return both_funcs[i];
+    }
+    return NULL;
+}
+
+// Every level keeps its own frames, set them all so switching levels keeps publishing
+void
+day4_set_grid_frames(GridFrames *frames)
+{
+    for (usize i = 0; i < ISA_COUNT; ++i) solver_levels[i].set_grid_frames(frames);
+}
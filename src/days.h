@@ -2,20 +2,134 @@
 #define DAYS_H
 
 #include "basic.h"
+#include "grid_frames.h"
 
-char *day1_part1(const char *input, usize input_length);
-char *day1_part2(const char *input, usize input_length);
+// Shared between a running solver and whoever started it. Long running
+// solvers report how far along they are and return NULL soon after being
+// cancelled. Both are only looked at every so often, in units of work of the
+// solver's choosing, so updates stay off the hot paths. Solvers may split
+// their work up on pool, see parallel_lines.h.
+typedef struct {
+    volatile u64 progress;       // Out of progress_total
+    volatile u64 progress_total; // 0 if the solver does not report progress
+    volatile u32 cancelled;
+    ThreadPool  *pool;           // NULL runs everything on the solver's thread
+} SolverContext;
 
-char *day2_part1(const char *input, usize input_length);
-char *day2_part2(const char *input, usize input_length);
+static inline void
+solver_report_progress(SolverContext *context, u64 progress, u64 progress_total)
+{
+    atomic_store_u64(&context->progress_total, progress_total);
+    atomic_store_u64(&context->progress, progress);
+}
 
-char *day3_part1(const char *input, usize input_length);
-char *day3_part2(const char *input, usize input_length);
+static inline bool
+solver_cancelled(SolverContext *context)
+{
+    return atomic_load_u32(&context->cancelled) != 0;
+}
 
-char *day4_part1(const char *input, usize input_length);
-char *day4_part2(const char *input, usize input_length);
+typedef char *(*ProblemFunc)(SolverContext *context, const char *input, usize input_length);
 
-char *day5_part1(const char *input, usize input_length);
-char *day5_part2(const char *input, usize input_length);
+// Both answers of a day, as two ProblemFuncs would return them. Both are
+// NULL if the solver was cancelled.
+typedef struct {
+    char *part1;
+    char *part2;
+} SolverAnswers;
+
+// Solves both parts of a day in one pass over the input, for days where that
+// is cheaper than running the parts one after the other
+typedef SolverAnswers (*SolveBothFunc)(SolverContext *context, const char *input, usize input_length);
+
+// Symbols the app looks up by name when the solvers are built as a hot
+// reloadable shared library (`bs --hot-reload`)
+#ifdef AOC2025_SOLVERS_SHARED
+#ifdef _MSC_VER
+#define SOLVER_EXPORT __declspec(dllexport)
+#else
+#define SOLVER_EXPORT __attribute__((visibility("default")))
+#endif
+#else
+#define SOLVER_EXPORT
+#endif
+
+// Hash of the solver sources and build flags, generated by bs. Changes
+// whenever a rebuilt solver could produce different answers.
+SOLVER_EXPORT u64 solver_build_id(void);
+
+// ISA_AUTO picks the highest level the cpu supports. Returns false, keeping
+// the current level, if the cpu does not support isa. Solvers not yet set
+// up use ISA_AUTO.
+SOLVER_EXPORT bool solvers_set_isa(Isa isa);
+SOLVER_EXPORT Isa  solvers_isa(void);
+
+// Frees the parsed inputs the days keep between runs. The app calls it before
+// unloading a hot reloaded library, whose caches would leak otherwise.
+SOLVER_EXPORT void solvers_flush_parsed_inputs(void);
+
+// The day sources are built once per Isa level, each build with its own
+// SOLVER_ISA_SUFFIX appended to the names below. days.c defines the names
+// themselves, and forwards to the level picked with solvers_set_isa().
+#define SOLVER_PROBLEMS(X, arg)               \
+    X(day1_part1, arg) X(day1_part2, arg) \
+    X(day2_part1, arg) X(day2_part2, arg) \
+    X(day3_part1, arg) X(day3_part2, arg) \
+    X(day4_part1, arg) X(day4_part2, arg) \
+    X(day5_part1, arg) X(day5_part2, arg)
+
+#define SOLVER_BOTH(X, arg)                         \
+    X(day1_solve_both, arg) X(day2_solve_both, arg) \
+    X(day3_solve_both, arg) X(day4_solve_both, arg)
+
+#ifdef SOLVER_ISA_SUFFIX
+#define SOLVER_ISA_PASTE_(name, suffix) name##suffix
+#define SOLVER_ISA_PASTE(name, suffix)  SOLVER_ISA_PASTE_(name, suffix)
+#define day1_part1           SOLVER_ISA_PASTE(day1_part1, SOLVER_ISA_SUFFIX)
+#define day1_part2           SOLVER_ISA_PASTE(day1_part2, SOLVER_ISA_SUFFIX)
+#define day1_solve_both      SOLVER_ISA_PASTE(day1_solve_both, SOLVER_ISA_SUFFIX)
+#define day2_part1           SOLVER_ISA_PASTE(day2_part1, SOLVER_ISA_SUFFIX)
+#define day2_part2           SOLVER_ISA_PASTE(day2_part2, SOLVER_ISA_SUFFIX)
+#define day2_solve_both      SOLVER_ISA_PASTE(day2_solve_both, SOLVER_ISA_SUFFIX)
+#define day3_part1           SOLVER_ISA_PASTE(day3_part1, SOLVER_ISA_SUFFIX)
+#define day3_part2           SOLVER_ISA_PASTE(day3_part2, SOLVER_ISA_SUFFIX)
+#define day3_solve_both      SOLVER_ISA_PASTE(day3_solve_both, SOLVER_ISA_SUFFIX)
+#define day4_part1           SOLVER_ISA_PASTE(day4_part1, SOLVER_ISA_SUFFIX)
+#define day4_part2           SOLVER_ISA_PASTE(day4_part2, SOLVER_ISA_SUFFIX)
+#define day4_solve_both      SOLVER_ISA_PASTE(day4_solve_both, SOLVER_ISA_SUFFIX)
+#define day4_set_grid_frames SOLVER_ISA_PASTE(day4_set_grid_frames, SOLVER_ISA_SUFFIX)
+#define day5_part1           SOLVER_ISA_PASTE(day5_part1, SOLVER_ISA_SUFFIX)
+#define day5_part2           SOLVER_ISA_PASTE(day5_part2, SOLVER_ISA_SUFFIX)
+// Only the names in days.c are looked up by the app
+#undef  SOLVER_EXPORT
+#define SOLVER_EXPORT
+#endif
+
+SOLVER_EXPORT char *day1_part1(SolverContext *context, const char *input, usize input_length);
+SOLVER_EXPORT char *day1_part2(SolverContext *context, const char *input, usize input_length);
+SOLVER_EXPORT SolverAnswers day1_solve_both(SolverContext *context, const char *input, usize input_length);
+
+SOLVER_EXPORT char *day2_part1(SolverContext *context, const char *input, usize input_length);
+SOLVER_EXPORT char *day2_part2(SolverContext *context, const char *input, usize input_length);
+SOLVER_EXPORT SolverAnswers day2_solve_both(SolverContext *context, const char *input, usize input_length);
+
+SOLVER_EXPORT char *day3_part1(SolverContext *context, const char *input, usize input_length);
+SOLVER_EXPORT char *day3_part2(SolverContext *context, const char *input, usize input_length);
+SOLVER_EXPORT SolverAnswers day3_solve_both(SolverContext *context, const char *input, usize input_length);
+
+SOLVER_EXPORT char *day4_part1(SolverContext *context, const char *input, usize input_length);
+SOLVER_EXPORT char *day4_part2(SolverContext *context, const char *input, usize input_length);
+SOLVER_EXPORT SolverAnswers day4_solve_both(SolverContext *context, const char *input, usize input_length);
+// Frames to publish every round of part 2 to, when it is solving frames->input.
+// 255 is a roll of paper, 96 a roll removed in that round. NULL to stop.
+SOLVER_EXPORT void  day4_set_grid_frames(GridFrames *frames);
+
+SOLVER_EXPORT char *day5_part1(SolverContext *context, const char *input, usize input_length);
+SOLVER_EXPORT char *day5_part2(SolverContext *context, const char *input, usize input_length);
+
+// Looks a solver up by its name, "day1_part1" and so on. NULL if there is none.
+SOLVER_EXPORT ProblemFunc   solver_find(const char *name);
+// Same for the SolveBothFuncs, "day1_solve_both" and so on
+SOLVER_EXPORT SolveBothFunc solver_find_both(const char *name);
 
 #endif
@@ -0,0 +1,43 @@
+#ifndef EMBEDDED_H
+#define EMBEDDED_H
+
+// Data compiled into the app. bs generates the definitions in
+// build/generated/aoc2025: embedded_data.c holds the files under data/ and
+// embedded_fonts.c the font atlases, rasterized at build time by
+// tools/bake_fonts.c the same way raylib's LoadFontEx would at runtime.
+
+#ifdef _MSC_VER
+#define EMBEDDED_ALIGNED __declspec(align(64))
+#else
+#define EMBEDDED_ALIGNED __attribute__((aligned(64)))
+#endif
+
+typedef struct {
+    const char          *path; // As in the repository, "data/day1/title.txt"
+    const unsigned char *data; // Followed by a zero byte, so text files are C strings
+    unsigned int         size;
+} EmbeddedFile;
+
+typedef struct {
+    int   value;
+    int   offset_x, offset_y;
+    int   advance_x;
+    float x, y, width, height; // Rectangle in the atlas
+} EmbeddedGlyph;
+
+typedef struct {
+    const char          *path;
+    int                  size;
+    int                  padding;
+    int                  glyph_count;
+    const EmbeddedGlyph *glyphs;
+    int                  atlas_width;
+    int                  atlas_height;
+    const unsigned char *atlas; // One byte of coverage per pixel
+} EmbeddedFont;
+
+// Both return NULL if nothing was embedded for the arguments
+const EmbeddedFile *embedded_file(const char *path);
+const EmbeddedFont *embedded_font(const char *path, int size);
+
+#endif
@@ -0,0 +1,66 @@
+#include "grid_frames.h"
+
+#include <string.h>
+
+void
+grid_frames_init(GridFrames *frames, const char *input, u32 width, u32 height)
+{
+    grid_frames_free(frames);
+
+    usize cell_count = (usize)width * (usize)height;
+    u8   *cells      = (u8 *)calloc(3, cell_count ? cell_count : 1);
+    for (u32 i = 0; i < 3; ++i) frames->cells[i] = cells + i*cell_count;
+
+    frames->input       = input;
+    frames->width       = width;
+    frames->height      = height;
+    frames->write_index = 0;
+    frames->shared      = 1;
+    frames->read_index  = 2;
+}
+
+void
+grid_frames_free(GridFrames *frames)
+{
+    free(frames->cells[0]);
+    void (*on_publish)(void) = frames->on_publish;
+    memset(frames, 0, sizeof(*frames));
+    frames->on_publish = on_publish;
+}
+
+u8 *
+grid_frames_write_buffer(GridFrames *frames)
+{
+    return frames->cells[frames->write_index];
+}
+
+void
+grid_frames_publish(GridFrames *frames, u32 round)
+{
+    frames->rounds[frames->write_index] = round;
+    // The exchange orders the cell writes before the frame becomes visible
+    frames->write_index = atomic_exchange_u32(&frames->shared, frames->write_index | GRID_FRAMES_FRESH) & ~GRID_FRAMES_FRESH;
+    atomic_fetch_add_u32(&frames->published_count, 1);
+    if (frames->on_publish) frames->on_publish();
+}
+
+bool
+grid_frames_acquire(GridFrames *frames)
+{
+    if (!frames->cells[0]) return false;
+    if (!(atomic_load_u32(&frames->shared) & GRID_FRAMES_FRESH)) return false;
+    frames->read_index = atomic_exchange_u32(&frames->shared, frames->read_index) & ~GRID_FRAMES_FRESH;
+    return true;
+}
+
+const u8 *
+grid_frames_read_buffer(GridFrames *frames)
+{
+    return frames->cells[frames->read_index];
+}
+
+u32
+grid_frames_read_round(GridFrames *frames)
+{
+    return frames->rounds[frames->read_index];
+}
@@ -0,0 +1,43 @@
+#ifndef GRID_FRAMES_H
+#define GRID_FRAMES_H
+
+#include "basic.h"
+
+// Triple buffered grid frames, handed from a solver to the UI without either
+// side waiting on the other. The solver fills the write buffer and publishes
+// it, the UI acquires the newest published frame whenever it draws. Frames
+// the UI never got to are overwritten. Exactly one thread may write and one
+// may read.
+//
+// A frame is width*height bytes, one per cell, row by row. The values are up
+// to the solver, the UI uploads them as a grayscale texture.
+
+#define GRID_FRAMES_FRESH 4u // Set in shared when it holds a frame the reader has not seen
+
+typedef struct {
+    const char  *input;  // Input the frames are wanted for, solvers ignore any other
+    u32          width;
+    u32          height;
+    u8          *cells[3];
+    u32          rounds[3];
+    void       (*on_publish)(void); // Called on the writer after each publish, may be NULL
+
+    volatile u32 shared;          // Index of the middle buffer, plus GRID_FRAMES_FRESH
+    volatile u32 published_count;
+    u32          write_index;     // Owned by the writer
+    u32          read_index;      // Owned by the reader
+} GridFrames;
+
+void grid_frames_init(GridFrames *frames, const char *input, u32 width, u32 height);
+void grid_frames_free(GridFrames *frames);
+
+// Writer
+u8  *grid_frames_write_buffer(GridFrames *frames);
+void grid_frames_publish(GridFrames *frames, u32 round);
+
+// Reader. Returns true, and makes it the read buffer, if a newer frame was published.
+bool      grid_frames_acquire(GridFrames *frames);
+const u8 *grid_frames_read_buffer(GridFrames *frames);
+u32       grid_frames_read_round(GridFrames *frames);
+
+#endif
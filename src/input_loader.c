@@ -0,0 +1,428 @@
+#ifndef _MSC_VER
+#define _GNU_SOURCE // syscall
+#endif
+
+#include "input_loader.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _MSC_VER
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#define INPUT_LOADER_HAS_IO_URING
+#endif
+
+typedef struct {
+    ThreadPool         *pool; // NULL runs the callbacks on the loading thread
+    TaskGroup           group;
+    const char *const  *paths;
+    InputLoadedFunc     func;
+    void               *user_data;
+
+    // io_uring only
+    u8                 *buffers; // INPUT_LOADER_BUFFER_COUNT of INPUT_LOADER_BUFFER_SIZE bytes
+    volatile u32        free_lock;
+    u32                 free_buffers[INPUT_LOADER_BUFFER_COUNT];
+    volatile u32        free_count; // The loading thread waits on it while it is 0
+} Loader;
+
+typedef struct {
+    Loader *loader;
+    usize   index;
+    char   *data;
+    usize   size;
+    s32     buffer;    // Index of the buffer data is in, -1 if it is allocated
+    int     fd;        // While io_uring reads it
+    usize   file_size;
+} LoadedInput;
+
+const char *
+input_loader_backend_name(InputLoaderBackend backend)
+{
+    switch (backend) {
+    case INPUT_LOADER_IO_URING: return "io_uring";
+    case INPUT_LOADER_PREAD:    return "pread";
+    }
+    return "?";
+}
+
+static s32
+loader_take_buffer(Loader *loader)
+{
+    s32 buffer = -1;
+    spin_lock(&loader->free_lock);
+    if (loader->free_count) buffer = (s32)loader->free_buffers[--loader->free_count];
+    spin_unlock(&loader->free_lock);
+    return buffer;
+}
+
+static void
+loader_release_buffer(Loader *loader, s32 buffer)
+{
+    spin_lock(&loader->free_lock);
+    u32 free_count = loader->free_count;
+    loader->free_buffers[free_count] = (u32)buffer;
+    atomic_store_u32(&loader->free_count, free_count + 1);
+    spin_unlock(&loader->free_lock);
+    if (free_count == 0) address_wake_all(&loader->free_count);
+}
+
+// Blocks the loading thread until a callback hands a buffer back
+static void
+loader_wait_for_buffer(Loader *loader)
+{
+    TRACE_BEGIN("wait for buffer");
+    while (atomic_load_u32(&loader->free_count) == 0) address_wait(&loader->free_count, 0);
+    TRACE_END("wait for buffer");
+}
+
+static void
+loader_run(Loader *loader, TaskFunc func, LoadedInput *input)
+{
+    if (loader->pool) thread_pool_submit_group(loader->pool, &loader->group, func, input);
+    else              func(input);
+}
+
+static void
+deliver_input(void *user_data)
+{
+    LoadedInput *input  = (LoadedInput *)user_data;
+    Loader      *loader = input->loader;
+    loader->func(input->index, loader->paths[input->index], input->data, input->size, loader->user_data);
+
+    if (input->buffer >= 0) loader_release_buffer(loader, input->buffer);
+    else                    free(input->data);
+    input->data = NULL;
+}
+
+// Whole file plus a zero byte, NULL if it could not be read
+static char *
+read_file_pread(const char *path, usize *size)
+{
+#ifdef _MSC_VER
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *data = (char *)malloc(length > 0 ? (usize)length + 1 : 1);
+    *size = length > 0 ? fread(data, 1, (usize)length, file) : 0;
+    fclose(file);
+#else
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+
+    char *data = (char *)malloc((usize)st.st_size + 1);
+    *size = 0;
+    while (*size < (usize)st.st_size) {
+        ssize_t read_count = pread(fd, data + *size, (usize)st.st_size - *size, (off_t)*size);
+        if (read_count < 0 && errno == EINTR) continue;
+        if (read_count <= 0) break;
+        *size += (usize)read_count;
+    }
+    close(fd);
+#endif
+    data[*size] = 0;
+    return data;
+}
+
+static void
+pread_and_deliver_input(void *user_data)
+{
+    LoadedInput *input = (LoadedInput *)user_data;
+    TRACE_BEGIN("pread input");
+    input->data   = read_file_pread(input->loader->paths[input->index], &input->size);
+    input->buffer = -1;
+    TRACE_END("pread input");
+    deliver_input(input);
+}
+
+#ifdef INPUT_LOADER_HAS_IO_URING
+// The parts of liburing the loader needs, on the raw system calls
+typedef struct {
+    int                  fd;
+    bool                 fixed_buffers; // Registering them can fail on RLIMIT_MEMLOCK
+    u32                  to_submit;
+
+    volatile u32        *sq_head;
+    volatile u32        *sq_tail;
+    u32                  sq_mask;
+    u32                  sq_entries;
+    u32                 *sq_array;
+    struct io_uring_sqe *sqes;
+
+    volatile u32        *cq_head;
+    volatile u32        *cq_tail;
+    u32                  cq_mask;
+    struct io_uring_cqe *cqes;
+
+    void                *sq_ring;
+    usize                sq_ring_size;
+    void                *cq_ring;
+    usize                cq_ring_size;
+    usize                sqes_size;
+} Ring;
+
+static bool
+ring_init(Ring *ring, u32 entries)
+{
+    *ring = (Ring){.fd = -1};
+
+    struct io_uring_params params = {0};
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) return false;
+    ring->fd = fd;
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(u32);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap && ring->cq_ring_size > ring->sq_ring_size) ring->sq_ring_size = ring->cq_ring_size;
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) goto fail;
+    if (single_mmap) {
+        ring->cq_ring      = ring->sq_ring;
+        ring->cq_ring_size = 0;
+    } else {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ring == MAP_FAILED) goto fail;
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe *)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) goto fail;
+
+    u8 *sq = (u8 *)ring->sq_ring;
+    ring->sq_head    = (volatile u32 *)(sq + params.sq_off.head);
+    ring->sq_tail    = (volatile u32 *)(sq + params.sq_off.tail);
+    ring->sq_mask    = *(u32 *)(sq + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+    ring->sq_array   = (u32 *)(sq + params.sq_off.array);
+
+    u8 *cq = (u8 *)ring->cq_ring;
+    ring->cq_head = (volatile u32 *)(cq + params.cq_off.head);
+    ring->cq_tail = (volatile u32 *)(cq + params.cq_off.tail);
+    ring->cq_mask = *(u32 *)(cq + params.cq_off.ring_mask);
+    ring->cqes    = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    return true;
+
+fail:
+    if (ring->sq_ring && ring->sq_ring != MAP_FAILED) munmap(ring->sq_ring, ring->sq_ring_size);
+    if (ring->cq_ring && ring->cq_ring != MAP_FAILED && ring->cq_ring_size) munmap(ring->cq_ring, ring->cq_ring_size);
+    close(fd);
+    return false;
+}
+
+static void
+ring_destroy(Ring *ring)
+{
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring_size) munmap(ring->cq_ring, ring->cq_ring_size);
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+}
+
+// Queues a read of the rest of input's file, submitted by the next ring_enter()
+static void
+ring_queue_read(Ring *ring, LoadedInput *input)
+{
+    // Only this thread adds entries, and there are never more in flight than the ring holds
+    u32 tail  = *ring->sq_tail;
+    u32 index = tail & ring->sq_mask;
+
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd        = input->fd;
+    sqe->addr      = (u64)(usize)(input->data + input->size);
+    sqe->len       = (u32)(input->file_size - input->size);
+    sqe->off       = input->size;
+    sqe->user_data = (u64)(usize)input;
+    if (ring->fixed_buffers) {
+        sqe->opcode    = IORING_OP_READ_FIXED;
+        sqe->buf_index = (u16)input->buffer;
+    } else {
+        sqe->opcode = IORING_OP_READ;
+    }
+
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ring->to_submit += 1;
+}
+
+// Submits the queued reads and waits for at least one completion
+static bool
+ring_enter(Ring *ring)
+{
+    for (;;) {
+        int submitted = (int)syscall(__NR_io_uring_enter, ring->fd, ring->to_submit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (submitted >= 0) {
+            ring->to_submit -= (u32)submitted;
+            return true;
+        }
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY) return false;
+    }
+}
+
+static void
+finish_io_uring_read(Loader *loader, LoadedInput *input)
+{
+    close(input->fd);
+    input->fd = -1;
+    input->data[input->size] = 0;
+    loader_run(loader, deliver_input, input);
+}
+
+// Hands a file to pread after all, e.g. if it is too large for a buffer
+static void
+fall_back_to_pread(Loader *loader, LoadedInput *input)
+{
+    if (input->fd >= 0) close(input->fd);
+    input->fd = -1;
+    if (input->buffer >= 0) loader_release_buffer(loader, input->buffer);
+    input->buffer = -1;
+    loader_run(loader, pread_and_deliver_input, input);
+}
+
+static bool
+load_with_io_uring(Loader *loader, LoadedInput *inputs, usize input_count)
+{
+    Ring ring;
+    if (!ring_init(&ring, INPUT_LOADER_BUFFER_COUNT)) return false;
+
+    loader->buffers = (u8 *)malloc((usize)INPUT_LOADER_BUFFER_COUNT * INPUT_LOADER_BUFFER_SIZE);
+    struct iovec iovecs[INPUT_LOADER_BUFFER_COUNT];
+    for (u32 i = 0; i < INPUT_LOADER_BUFFER_COUNT; ++i) {
+        iovecs[i] = (struct iovec){loader->buffers + (usize)i * INPUT_LOADER_BUFFER_SIZE, INPUT_LOADER_BUFFER_SIZE};
+        loader->free_buffers[i] = INPUT_LOADER_BUFFER_COUNT - 1 - i;
+    }
+    loader->free_count = INPUT_LOADER_BUFFER_COUNT;
+    ring.fixed_buffers = syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_BUFFERS, iovecs, INPUT_LOADER_BUFFER_COUNT) == 0;
+
+    usize next_input = 0;
+    u32   in_flight  = 0;
+    bool  ring_ok    = true;
+    while (next_input < input_count || in_flight) {
+        // Start as many reads as there are free buffers. Opening stays
+        // synchronous, the file size decides whether it fits.
+        while (ring_ok && next_input < input_count && in_flight < ring.sq_entries) {
+            s32 buffer = loader_take_buffer(loader);
+            if (buffer < 0) break;
+
+            LoadedInput *input = &inputs[next_input++];
+            input->buffer = buffer;
+            input->data   = (char *)loader->buffers + (usize)buffer * INPUT_LOADER_BUFFER_SIZE;
+            input->size   = 0;
+            input->fd     = open(loader->paths[input->index], O_RDONLY | O_CLOEXEC);
+
+            struct stat st;
+            if (input->fd < 0 || fstat(input->fd, &st) != 0 || (usize)st.st_size >= INPUT_LOADER_BUFFER_SIZE) {
+                fall_back_to_pread(loader, input);
+                continue;
+            }
+            input->file_size = (usize)st.st_size;
+            if (input->file_size == 0) {
+                finish_io_uring_read(loader, input);
+                continue;
+            }
+            ring_queue_read(&ring, input);
+            in_flight += 1;
+        }
+
+        if (in_flight == 0) {
+            // Every buffer is with a callback, wait for one to come back
+            if (next_input < input_count) loader_wait_for_buffer(loader);
+            continue;
+        }
+
+        TRACE_BEGIN("io_uring wait");
+        ring_ok = ring_enter(&ring);
+        TRACE_END("io_uring wait");
+        if (!ring_ok) break;
+
+        u32 head = *ring.cq_head;
+        u32 tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            struct io_uring_cqe *cqe   = &ring.cqes[head & ring.cq_mask];
+            LoadedInput         *input = (LoadedInput *)(usize)cqe->user_data;
+            if (cqe->res < 0) {
+                in_flight -= 1;
+                fall_back_to_pread(loader, input);
+            } else if (cqe->res == 0 || input->size + (usize)cqe->res == input->file_size) {
+                // Done, or the file shrank since fstat
+                input->size += (usize)cqe->res;
+                in_flight -= 1;
+                finish_io_uring_read(loader, input);
+            } else {
+                // Short read, ask for the rest
+                input->size += (usize)cqe->res;
+                ring_queue_read(&ring, input);
+            }
+        }
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    // io_uring_enter only fails like this if the ring itself broke. The
+    // kernel may still write to the buffers of reads in flight, so those
+    // are left alone for good, and their files and the rest go to pread.
+    if (!ring_ok) {
+        for (usize i = 0; i < next_input; ++i) {
+            if (inputs[i].fd < 0) continue;
+            inputs[i].buffer = -1;
+            fall_back_to_pread(loader, &inputs[i]);
+        }
+        for (usize i = next_input; i < input_count; ++i) loader_run(loader, pread_and_deliver_input, &inputs[i]);
+    }
+
+    if (loader->pool) thread_pool_wait_group(loader->pool, &loader->group);
+    ring_destroy(&ring);
+    if (ring_ok) free(loader->buffers);
+    return true;
+}
+#endif
+
+InputLoaderBackend
+load_inputs(ThreadPool *pool, const char *const *paths, usize path_count, bool allow_io_uring,
+            InputLoadedFunc func, void *user_data)
+{
+    TRACE_BEGIN("load_inputs");
+    Loader loader = {
+        .pool      = pool,
+        .paths     = paths,
+        .func      = func,
+        .user_data = user_data,
+    };
+    LoadedInput *inputs = (LoadedInput *)calloc(path_count ? path_count : 1, sizeof(*inputs));
+    for (usize i = 0; i < path_count; ++i) inputs[i] = (LoadedInput){.loader = &loader, .index = i, .buffer = -1, .fd = -1};
+
+    InputLoaderBackend backend = INPUT_LOADER_PREAD;
+#ifdef INPUT_LOADER_HAS_IO_URING
+    if (allow_io_uring && load_with_io_uring(&loader, inputs, path_count)) backend = INPUT_LOADER_IO_URING;
+#else
+    UNUSED(allow_io_uring);
+#endif
+
+    if (backend == INPUT_LOADER_PREAD) {
+        for (usize i = 0; i < path_count; ++i) loader_run(&loader, pread_and_deliver_input, &inputs[i]);
+        if (pool) thread_pool_wait_group(pool, &loader.group);
+    }
+
+    free(inputs);
+    TRACE_END("load_inputs");
+    return backend;
+}
@@ -0,0 +1,38 @@
+#ifndef INPUT_LOADER_H
+#define INPUT_LOADER_H
+
+#include "basic.h"
+
+// Loads many input files and hands each one to a callback as soon as it has
+// been read, so reading the next files overlaps with solving the previous
+// ones.
+//
+// On Linux the reads go through io_uring, into a fixed set of buffers that
+// are registered with the kernel once. A buffer returns to the ring when
+// the callback for its file is done, so at most INPUT_LOADER_BUFFER_COUNT
+// files are held at a time. Files larger than a buffer, and every file
+// where io_uring is unavailable (other systems, older kernels, or seccomp
+// filters in containers), are read with pread on the pool instead.
+
+#define INPUT_LOADER_BUFFER_COUNT 64
+#define INPUT_LOADER_BUFFER_SIZE  (256*1024)
+
+// Runs on a pool thread, or on the loading thread without a pool. data is
+// the whole file followed by a zero byte, or NULL if it could not be read,
+// and is only valid during the call.
+typedef void (*InputLoadedFunc)(usize index, const char *path, const char *data, usize size, void *user_data);
+
+typedef enum {
+    INPUT_LOADER_IO_URING,
+    INPUT_LOADER_PREAD,
+} InputLoaderBackend;
+
+// Calls func once for every path and returns when all calls are done.
+// allow_io_uring false always uses pread, to compare the two. Returns the
+// backend that was used.
+InputLoaderBackend load_inputs(ThreadPool *pool, const char *const *paths, usize path_count, bool allow_io_uring,
+                               InputLoadedFunc func, void *user_data);
+
+const char *input_loader_backend_name(InputLoaderBackend backend);
+
+#endif
@@ -1,19 +1,42 @@
 #include "aoc2025.h"
 
 #include <stdio.h>
+#include <dlfcn.h>
 
 extern void *GetWindowHandle(void);
 
+const char *solver_library_path = "build/bin/libaoc2025_solvers.so";
+
 void
 set_native_window_icon(void)
 {
 
 }
 
+void *
+library_load(const char *path)
+{
+    void *library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!library) fprintf(stderr, "%s\n", dlerror());
+    return library;
+}
+
+void *
+library_symbol(void *library, const char *name)
+{
+    return dlsym(library, name);
+}
+
+void
+library_unload(void *library)
+{
+    dlclose(library);
+}
+
 int
-main(void)
+main(int argc, char **argv)
 {
-    int exit_code = aoc2025_entry();
+    int exit_code = aoc2025_entry(argc, argv);
 
     return exit_code;
 }
@@ -0,0 +1,112 @@
+#include "parallel_lines.h"
+#include "trace.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_TRACK_REDIRECT
+#include "alloc_track.h"
+
+// Chunk states are written by different threads, each gets cache lines of
+// its own
+#define CACHE_LINE_SIZE 64
+
+typedef struct {
+    StringView    lines;
+    void         *state;
+    LinesFunc     func;
+    void         *user_data;
+    AllocTracker *alloc_tracker; // The calling solver's, counts the chunk's allocations on any thread
+} LinesChunk;
+
+static void
+run_lines_chunk(void *user_data)
+{
+    TRACE_BEGIN("lines chunk");
+    LinesChunk   *chunk    = (LinesChunk *)user_data;
+    AllocTracker *previous = alloc_track_attach(chunk->alloc_tracker);
+    chunk->func(chunk->lines, chunk->state, chunk->user_data);
+    alloc_track_attach(previous);
+    TRACE_END("lines chunk");
+}
+
+// Cuts input into chunks, returns how many. Chunk i starts where chunk i - 1
+// ends, and ends after the first '\n' at or past its share of the input.
+// Shares that fall inside one long line make no chunk of their own.
+static usize
+split_lines(StringView input, usize grain_size, StringView *chunks)
+{
+    usize wanted = grain_size ? input.length / grain_size : 1;
+    if (wanted < 1)                         wanted = 1;
+    if (wanted > PARALLEL_LINES_MAX_CHUNKS) wanted = PARALLEL_LINES_MAX_CHUNKS;
+
+    usize chunk_count = 0;
+    usize begin       = 0;
+    for (usize i = 1; i <= wanted && begin < input.length; ++i) {
+        usize end = i == wanted ? input.length : input.length / wanted * i;
+        if (end < begin) end = begin;
+        if (end < input.length) {
+            const char *newline = (const char *)memchr(input.begin + end, '\n', input.length - end);
+            end = newline ? (usize)(newline - input.begin) + 1 : input.length;
+        }
+        chunks[chunk_count++] = sv_from_parts(input.begin + begin, end - begin);
+        begin = end;
+    }
+    return chunk_count;
+}
+
+static void
+run_lines(ThreadPool *pool, StringView input, usize grain_size, usize state_size,
+          LinesFunc func, LinesReduceFunc reduce, void *result, void *user_data)
+{
+    StringView chunks[PARALLEL_LINES_MAX_CHUNKS];
+    usize      chunk_count = pool ? split_lines(input, grain_size, chunks) : 0;
+    if (chunk_count <= 1) {
+        // Not worth a task, and not worth copying the state either
+        void *state = state_size ? calloc(1, state_size) : NULL;
+        func(input, state, user_data);
+        if (reduce) reduce(result, state, user_data);
+        free(state);
+        return;
+    }
+
+    // One allocation for all states, with room to start it on a cache line
+    usize state_stride = (state_size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+    u8   *state_block  = state_size ? (u8 *)calloc(chunk_count * state_stride + CACHE_LINE_SIZE - 1, 1) : NULL;
+    u8   *states       = state_block ? (u8 *)(((usize)state_block + CACHE_LINE_SIZE - 1) & ~(usize)(CACHE_LINE_SIZE - 1)) : NULL;
+
+    LinesChunk    tasks[PARALLEL_LINES_MAX_CHUNKS];
+    AllocTracker *alloc_tracker = alloc_track_current();
+    for (usize i = 0; i < chunk_count; ++i) {
+        tasks[i] = (LinesChunk){
+            .lines         = chunks[i],
+            .state         = states ? states + i*state_stride : NULL,
+            .func          = func,
+            .user_data     = user_data,
+            .alloc_tracker = alloc_tracker,
+        };
+    }
+
+    TaskGroup group = {0};
+    for (usize i = 1; i < chunk_count; ++i) thread_pool_submit_group(pool, &group, run_lines_chunk, &tasks[i]);
+    run_lines_chunk(&tasks[0]);
+    thread_pool_wait_group(pool, &group);
+
+    if (reduce) {
+        for (usize i = 0; i < chunk_count; ++i) reduce(result, tasks[i].state, user_data);
+    }
+    free(state_block);
+}
+
+void
+parallel_for_lines(ThreadPool *pool, StringView input, usize grain_size, LinesFunc func, void *user_data)
+{
+    run_lines(pool, input, grain_size, 0, func, NULL, NULL, user_data);
+}
+
+void
+parallel_reduce_lines(ThreadPool *pool, StringView input, usize grain_size, usize state_size,
+                      LinesFunc func, LinesReduceFunc reduce, void *result, void *user_data)
+{
+    run_lines(pool, input, grain_size, state_size, func, reduce, result, user_data);
+}
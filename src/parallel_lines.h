@@ -0,0 +1,33 @@
+#ifndef PARALLEL_LINES_H
+#define PARALLEL_LINES_H
+
+#include "basic.h"
+
+#include "sv.h"
+
+// Splitting line based inputs across a thread pool. The input is cut into
+// chunks of about grain_size bytes, each ending just after a '\n' (or at the
+// end of the input), so every line is in exactly one chunk and no line is
+// ever split. Chunks run as tasks of a TaskGroup, the calling thread runs the
+// first one itself and helps with the rest while it waits.
+//
+// Inputs up to grain_size bytes, or a NULL pool, run as a single chunk on the
+// calling thread, without touching the pool.
+
+#define PARALLEL_LINES_MAX_CHUNKS 256
+
+// state is NULL for parallel_for_lines()
+typedef void (*LinesFunc)(StringView lines, void *state, void *user_data);
+// Folds the state of one chunk into result
+typedef void (*LinesReduceFunc)(void *result, void *state, void *user_data);
+
+void parallel_for_lines(ThreadPool *pool, StringView input, usize grain_size, LinesFunc func, void *user_data);
+
+// Every chunk gets its own zeroed state_size bytes of state, starting on a
+// cache line and not sharing one with another chunk. Once all of them
+// are done, reduce folds the states into result one by one, on the calling
+// thread and in input order, so it may append and needs no locking.
+void parallel_reduce_lines(ThreadPool *pool, StringView input, usize grain_size, usize state_size,
+                           LinesFunc func, LinesReduceFunc reduce, void *result, void *user_data);
+
+#endif
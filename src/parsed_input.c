@@ -0,0 +1,140 @@
+#include "parsed_input.h"
+#include "trace.h"
+
+#include <string.h>
+
+// Every cache that was used, for parsed_input_flush_all()
+static volatile u32      registry_lock;
+static ParsedInputCache *registered_caches;
+
+static void
+register_cache(ParsedInputCache *cache)
+{
+    spin_lock(&registry_lock);
+    if (!cache->registered) {
+        cache->next       = registered_caches;
+        registered_caches = cache;
+        atomic_store_u32(&cache->registered, 1);
+    }
+    spin_unlock(&registry_lock);
+}
+
+static void *
+parse(ParsedInputCache *cache, SolverContext *context, const char *input, usize input_length)
+{
+    TRACE_BEGIN("parse input");
+    void *parsed = cache->parse(context, input, input_length);
+    TRACE_END("parse input");
+    return parsed;
+}
+
+// Blocks until the slot's parse is done, the caller counts as one of its users
+static void *
+wait_until_parsed(ParsedInputCache *cache, ParsedInputSlot *slot)
+{
+    while (atomic_load_u32(&slot->state) == PARSED_INPUT_PARSING) {
+        address_wait(&slot->state, PARSED_INPUT_PARSING);
+    }
+    spin_lock(&cache->lock);
+    void *parsed = slot->parsed;
+    spin_unlock(&cache->lock);
+    return parsed;
+}
+
+const void *
+parsed_input_acquire(ParsedInputCache *cache, SolverContext *context, const char *input, usize input_length)
+{
+    if (!atomic_load_u32(&cache->registered)) register_cache(cache);
+    u64 hash = hash_bytes(input, input_length, 0);
+
+    spin_lock(&cache->lock);
+    cache->use_count += 1;
+
+    ParsedInputSlot *victim = NULL;
+    for (usize i = 0; i < PARSED_INPUT_SLOTS; ++i) {
+        ParsedInputSlot *slot = &cache->slots[i];
+        if (slot->state != PARSED_INPUT_EMPTY && slot->hash == hash && slot->length == input_length) {
+            // Holding the slot keeps its input copy from changing, so the
+            // bytes are compared outside the lock
+            slot->user_count += 1;
+            slot->last_used   = cache->use_count;
+            spin_unlock(&cache->lock);
+            if (memcmp(slot->input, input, input_length) == 0) return wait_until_parsed(cache, slot);
+
+            // Another input with the same hash, parsed privately as it is
+            // too rare to evict for
+            spin_lock(&cache->lock);
+            slot->user_count -= 1;
+            spin_unlock(&cache->lock);
+            return parse(cache, context, input, input_length);
+        }
+        if (slot->user_count == 0 && (!victim || slot->last_used < victim->last_used)) victim = slot;
+    }
+
+    // Every slot is in use, the caller gets a private parse that release frees
+    if (!victim) {
+        spin_unlock(&cache->lock);
+        return parse(cache, context, input, input_length);
+    }
+
+    // The slot is claimed for this input before parsing, so callers with the
+    // same input wait on it while everyone else goes on
+    void *evicted       = victim->parsed;
+    char *evicted_input = victim->input;
+    char *input_copy    = (char *)malloc(input_length + 1);
+    memcpy(input_copy, input, input_length);
+    victim->state      = PARSED_INPUT_PARSING;
+    victim->parsed     = NULL;
+    victim->input      = input_copy;
+    victim->hash       = hash;
+    victim->length     = input_length;
+    victim->user_count = 1;
+    victim->last_used  = cache->use_count;
+    spin_unlock(&cache->lock);
+
+    if (evicted) cache->free(evicted);
+    free(evicted_input);
+
+    void *parsed = parse(cache, context, input, input_length);
+
+    spin_lock(&cache->lock);
+    victim->parsed = parsed;
+    atomic_store_u32(&victim->state, PARSED_INPUT_READY);
+    spin_unlock(&cache->lock);
+    address_wake_all(&victim->state);
+    return parsed;
+}
+
+void
+parsed_input_release(ParsedInputCache *cache, const void *parsed)
+{
+    spin_lock(&cache->lock);
+    for (usize i = 0; i < PARSED_INPUT_SLOTS; ++i) {
+        ParsedInputSlot *slot = &cache->slots[i];
+        if (slot->state == PARSED_INPUT_READY && slot->parsed == parsed) {
+            slot->user_count -= 1;
+            spin_unlock(&cache->lock);
+            return;
+        }
+    }
+    spin_unlock(&cache->lock);
+    cache->free((void *)parsed);
+}
+
+void
+parsed_input_flush_all(void)
+{
+    spin_lock(&registry_lock);
+    for (ParsedInputCache *cache = registered_caches; cache; cache = cache->next) {
+        spin_lock(&cache->lock);
+        for (usize i = 0; i < PARSED_INPUT_SLOTS; ++i) {
+            ParsedInputSlot *slot = &cache->slots[i];
+            if (slot->state != PARSED_INPUT_READY || slot->user_count != 0) continue;
+            cache->free(slot->parsed);
+            free(slot->input);
+            *slot = (ParsedInputSlot){0};
+        }
+        spin_unlock(&cache->lock);
+    }
+    spin_unlock(&registry_lock);
+}
@@ -0,0 +1,59 @@
+#ifndef PARSED_INPUT_H
+#define PARSED_INPUT_H
+
+#include "basic.h"
+#include "days.h"
+
+// Inputs parsed once for both parts of a day. Every day keeps a cache of its
+// parsed inputs, keyed on the input bytes, so whichever part runs second, and
+// every repeated run, reuses the first parse. A part that asks while another
+// one is parsing the same input waits for it. Parses of different inputs run
+// at the same time, the lock only covers the slot bookkeeping.
+
+#define PARSED_INPUT_SLOTS 4 // Enough for the test, real and generated inputs of a day
+
+typedef void *(*ParseFunc)(SolverContext *context, const char *input, usize input_length);
+typedef void  (*ParsedFreeFunc)(void *parsed);
+
+typedef enum {
+    PARSED_INPUT_EMPTY,
+    PARSED_INPUT_PARSING,
+    PARSED_INPUT_READY,
+} ParsedInputState;
+
+typedef struct {
+    volatile u32 state;      // ParsedInputState, waited on while parsing
+    void        *parsed;
+    char        *input;      // Copy of the input bytes, to confirm hash matches
+    u64          hash;       // Of the input bytes
+    usize        length;
+    u32          user_count; // Solvers holding or waiting for parsed, it is not evicted while any are
+    u64          last_used;
+} ParsedInputSlot;
+
+typedef struct ParsedInputCache ParsedInputCache;
+
+struct ParsedInputCache {
+    ParseFunc         parse;
+    ParsedFreeFunc    free;
+    volatile u32      lock;
+    u64               use_count;
+    ParsedInputSlot   slots[PARSED_INPUT_SLOTS];
+    volatile u32      registered; // Set once it is in the list parsed_input_flush_all() goes through
+    ParsedInputCache *next;
+};
+
+#define PARSED_INPUT_CACHE(parse_func, free_func) {.parse = (parse_func), .free = (free_func)}
+
+// Returns the input as parsed by cache->parse, which has to accept any input.
+// Hand it back with parsed_input_release() once done with it. The parse runs
+// on the caller's context, so it may use its thread pool.
+const void *parsed_input_acquire(ParsedInputCache *cache, SolverContext *context, const char *input, usize input_length);
+void        parsed_input_release(ParsedInputCache *cache, const void *parsed);
+
+// Frees the parses of every cache that was used so far, e.g. before the hot
+// reloaded solver library that owns them is unloaded. No solver may be
+// holding one.
+void        parsed_input_flush_all(void);
+
+#endif
@@ -0,0 +1,434 @@
+#include "runner.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *result_cache_directory = NULL;
+static void       (*run_job_wakeup)(void)  = NULL;
+
+static void
+format_duration(char *buffer, usize buffer_size, u64 ns)
+{
+    if      (ns < 1000ull)       snprintf(buffer, buffer_size, "%llu ns", (unsigned long long)ns);
+    else if (ns < 1000000ull)    snprintf(buffer, buffer_size, "%.2f us", (f64)ns / 1e3);
+    else if (ns < 1000000000ull) snprintf(buffer, buffer_size, "%.2f ms", (f64)ns / 1e6);
+    else                         snprintf(buffer, buffer_size, "%.2f s",  (f64)ns / 1e9);
+}
+
+static void
+format_size(char *buffer, usize buffer_size, usize bytes)
+{
+    if      (bytes < 1024)        snprintf(buffer, buffer_size, "%zu B", bytes);
+    else if (bytes < 1024 * 1024) snprintf(buffer, buffer_size, "%.1f KiB", (f64)bytes / 1024.0);
+    else                          snprintf(buffer, buffer_size, "%.1f MiB", (f64)bytes / (1024.0 * 1024.0));
+}
+
+static void
+format_allocation_summary(RunResult *result)
+{
+#ifdef AOC2025_ALLOC_TRACK
+    const AllocStats *stats = &result->allocations;
+    char bytes[32];
+    char peak[32];
+    format_size(bytes, sizeof(bytes), stats->bytes);
+    format_size(peak, sizeof(peak), stats->peak_live_bytes);
+
+    usize size    = sizeof(result->allocation_summary);
+    int   written = snprintf(result->allocation_summary, size, "%llu allocs (%s) | %llu frees | peak %s",
+                             (unsigned long long)stats->alloc_count, bytes, (unsigned long long)stats->free_count, peak);
+    for (u32 i = 0; i < stats->site_count && written > 0 && (usize)written < size; ++i) {
+        const AllocSite *site = &stats->top_sites[i];
+        // Only the file name, __FILE__ is however the compiler was given the path
+        const char *file = site->file;
+        for (const char *c = site->file; *c; ++c) {
+            if (*c == '/' || *c == '\\') file = c + 1;
+        }
+        format_size(bytes, sizeof(bytes), site->bytes);
+        written += snprintf(result->allocation_summary + written, size - (usize)written, "%s%s:%u x%llu (%s)",
+                            i == 0 ? " | top: " : ", ", file, site->line, (unsigned long long)site->count, bytes);
+    }
+#else
+    UNUSED(result);
+#endif
+}
+
+static void
+format_summary(RunResult *result)
+{
+    char solve_time[32];
+    char input_size[32];
+    format_duration(solve_time, sizeof(solve_time), result->solve_ns);
+    format_size(input_size, sizeof(input_size), result->input_size);
+
+    if (result->cancelled) {
+        snprintf(result->summary, sizeof(result->summary), "cancelled after %s | %s", solve_time, input_size);
+        return;
+    }
+
+    if (result->cached) {
+        snprintf(result->summary, sizeof(result->summary), "cached in %s | %s", solve_time, input_size);
+        return;
+    }
+
+    format_allocation_summary(result);
+
+    u64 ns = result->repeat_count ? result->min_ns : result->solve_ns;
+    f64 megabytes_per_second = ns ? ((f64)result->input_size / 1e6) / ((f64)ns / 1e9) : 0.0;
+
+    int written = snprintf(result->summary, sizeof(result->summary), "%s%s | %s | %.1f MB/s",
+                           result->both ? "both parts in " : "", solve_time, input_size, megabytes_per_second);
+
+    if (result->repeat_count && written > 0 && (usize)written < sizeof(result->summary)) {
+        char min_time[32];
+        char median_time[32];
+        format_duration(min_time, sizeof(min_time), result->min_ns);
+        format_duration(median_time, sizeof(median_time), result->median_ns);
+        snprintf(result->summary + written, sizeof(result->summary) - (usize)written,
+                 "\nx%u: min %s, median %s", result->repeat_count, min_time, median_time);
+    }
+}
+
+// The allocation tracker only counts while func runs, so repeated runs
+// leave the allocations of the last one in allocations
+static u64
+timed_solve(char **answer, AllocStats *allocations, SolverContext *context, ProblemFunc func,
+            const char *input, usize input_length)
+{
+    UNUSED(allocations);
+    TRACE_BEGIN("solve");
+    ALLOC_TRACK_BEGIN();
+    u64 begin_ns = time_now_ns();
+    *answer = func(context, input, input_length);
+    u64 end_ns = time_now_ns();
+    ALLOC_TRACK_END(allocations);
+    TRACE_END("solve");
+    return end_ns - begin_ns;
+}
+
+static u64
+timed_solve_both(SolverAnswers *answers, AllocStats *allocations, SolverContext *context, SolveBothFunc func,
+                 const char *input, usize input_length)
+{
+    UNUSED(allocations);
+    TRACE_BEGIN("solve both");
+    ALLOC_TRACK_BEGIN();
+    u64 begin_ns = time_now_ns();
+    *answers = func(context, input, input_length);
+    u64 end_ns = time_now_ns();
+    ALLOC_TRACK_END(allocations);
+    TRACE_END("solve both");
+    return end_ns - begin_ns;
+}
+
+void
+result_cache_set_directory(const char *directory)
+{
+    result_cache_directory = directory;
+    if (directory && !create_directories(directory)) {
+        fprintf(stderr, "Could not create result cache directory \"%s\", result cache disabled\n", directory);
+        result_cache_directory = NULL;
+    }
+}
+
+static char *
+result_cache_path(const char *solver_name, const char *input, usize input_length)
+{
+    u64 key = hash_bytes(input, input_length, solver_build_id());
+    key     = hash_bytes(solver_name, strlen(solver_name), key);
+    return sprint("%s/%016llx.txt", result_cache_directory, (unsigned long long)key);
+}
+
+static void
+result_cache_store(const char *path, const char *answer)
+{
+    // Write to a unique temporary file first, so concurrent workers never
+    // observe a partially written entry. Thread ids are only unique within
+    // a process, and the app and aoc_solve may share the cache.
+    char *temp_path = sprint("%s.%u.%u.tmp", path, current_process_id(), current_thread_id());
+    if (write_entire_file(temp_path, answer, strlen(answer))) {
+        remove(path);
+        if (rename(temp_path, path) != 0) remove(temp_path);
+    }
+    free(temp_path);
+}
+
+void
+run_solver(RunResult *result, SolverContext *context, const char *solver_name, ProblemFunc func,
+           const char *input, usize input_length)
+{
+    run_result_free(result);
+    result->input_size = input_length;
+
+    if (result_cache_directory && solver_name) {
+        u64 begin_ns = time_now_ns();
+        char *path   = result_cache_path(solver_name, input, input_length);
+        char *answer = read_entire_file(path);
+        if (answer) {
+            result->answer   = answer;
+            result->cached   = true;
+            result->solve_ns = time_now_ns() - begin_ns;
+        } else {
+            result->solve_ns = timed_solve(&result->answer, &result->allocations, context, func, input, input_length);
+            if (result->answer) result_cache_store(path, result->answer);
+        }
+        free(path);
+    } else {
+        result->solve_ns = timed_solve(&result->answer, &result->allocations, context, func, input, input_length);
+    }
+    result->cancelled = !result->answer && solver_cancelled(context);
+
+    format_summary(result);
+}
+
+static int
+compare_u64(const void *a, const void *b)
+{
+    u64 lhs = *(const u64 *)a;
+    u64 rhs = *(const u64 *)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+// Of sorted durations, the middle one or the mean of the two middle ones.
+// Halved before adding, so the sum can not overflow.
+static u64
+median_duration(const u64 *sorted_durations, u32 count)
+{
+    u64 upper = sorted_durations[count / 2];
+    if (count % 2 != 0) return upper;
+    u64 lower = sorted_durations[count / 2 - 1];
+    return lower / 2 + upper / 2 + (lower % 2 + upper % 2) / 2;
+}
+
+void
+run_solver_repeated(RunResult *result, SolverContext *context, ProblemFunc func,
+                    const char *input, usize input_length, u32 repeat_count)
+{
+    if (repeat_count == 0) repeat_count = 1;
+
+    run_result_free(result);
+    result->input_size = input_length;
+
+    u64 *durations = (u64 *)malloc(repeat_count * sizeof(*durations));
+    for (u32 i = 0; i < repeat_count; ++i) {
+        char *answer = NULL;
+        durations[i] = timed_solve(&answer, &result->allocations, context, func, input, input_length);
+        free(result->answer);
+        result->answer = answer;
+        if (!answer && solver_cancelled(context)) {
+            result->solve_ns  = durations[i];
+            result->cancelled = true;
+            free(durations);
+            format_summary(result);
+            return;
+        }
+    }
+
+    result->solve_ns     = durations[repeat_count - 1];
+    qsort(durations, repeat_count, sizeof(*durations), compare_u64);
+    result->repeat_count = repeat_count;
+    result->min_ns       = durations[0];
+    result->median_ns    = median_duration(durations, repeat_count);
+    free(durations);
+
+    format_summary(result);
+}
+
+void
+run_solver_both(RunResult *part1, RunResult *part2, SolverContext *context, const char *part1_name,
+                const char *part2_name, SolveBothFunc func, const char *input, usize input_length,
+                u32 repeat_count)
+{
+    if (repeat_count == 0) repeat_count = 1;
+
+    run_result_free(part1);
+    run_result_free(part2);
+    part1->input_size = input_length;
+    part2->input_size = input_length;
+
+    char *paths[2] = {0};
+    if (result_cache_directory && part1_name && part2_name && repeat_count == 1) {
+        u64 begin_ns = time_now_ns();
+        paths[0] = result_cache_path(part1_name, input, input_length);
+        paths[1] = result_cache_path(part2_name, input, input_length);
+        char *answer1 = read_entire_file(paths[0]);
+        char *answer2 = answer1 ? read_entire_file(paths[1]) : NULL;
+        if (answer1 && answer2) {
+            u64 lookup_ns = time_now_ns() - begin_ns;
+            *part1 = (RunResult){.answer = answer1, .input_size = input_length, .solve_ns = lookup_ns, .cached = true};
+            *part2 = (RunResult){.answer = answer2, .input_size = input_length, .solve_ns = lookup_ns, .cached = true};
+            free(paths[0]);
+            free(paths[1]);
+            format_summary(part1);
+            format_summary(part2);
+            return;
+        }
+        free(answer1);
+    }
+
+    u64 *durations = (u64 *)malloc(repeat_count * sizeof(*durations));
+    u32  run_count = 0;
+    bool cancelled = false;
+    while (run_count < repeat_count && !cancelled) {
+        SolverAnswers answers = {0};
+        durations[run_count] = timed_solve_both(&answers, &part1->allocations, context, func, input, input_length);
+        free(part1->answer);
+        free(part2->answer);
+        part1->answer = answers.part1;
+        part2->answer = answers.part2;
+        cancelled     = !answers.part1 && solver_cancelled(context);
+        run_count    += 1;
+    }
+
+    part1->solve_ns = durations[run_count - 1];
+    if (cancelled) {
+        part1->cancelled = true;
+    } else if (repeat_count > 1) {
+        qsort(durations, repeat_count, sizeof(*durations), compare_u64);
+        part1->repeat_count = repeat_count;
+        part1->min_ns       = durations[0];
+        part1->median_ns    = median_duration(durations, repeat_count);
+    } else if (paths[0] && part1->answer && part2->answer) {
+        result_cache_store(paths[0], part1->answer);
+        result_cache_store(paths[1], part2->answer);
+    }
+    free(durations);
+    free(paths[0]);
+    free(paths[1]);
+
+    // Everything but the answer is the same for both parts
+    part1->both = true;
+    char *part2_answer = part2->answer;
+    *part2         = *part1;
+    part2->answer  = part2_answer;
+
+    format_summary(part1);
+    format_summary(part2);
+}
+
+void
+run_result_free(RunResult *result)
+{
+    free(result->answer);
+    *result = (RunResult){0};
+}
+
+static void
+run_job_task(void *user_data)
+{
+    RunJob *job = (RunJob *)user_data;
+
+    if (job->both_func) {
+        RunJob *part2_job = job->fused_job;
+        run_solver_both(&job->result, &part2_job->result, &job->context, job->solver_name, part2_job->solver_name,
+                        job->both_func, job->input, job->input_length, job->repeat_count);
+
+        if (job->on_complete) {
+            job->on_complete(job);
+            job->on_complete(part2_job);
+        }
+        atomic_store_u32(&job->state, RUN_JOB_DONE);
+        atomic_store_u32(&part2_job->state, RUN_JOB_DONE);
+        if (run_job_wakeup) run_job_wakeup();
+        return;
+    }
+
+    if (job->repeat_count > 1) run_solver_repeated(&job->result, &job->context, job->func, job->input, job->input_length, job->repeat_count);
+    else                       run_solver(&job->result, &job->context, job->solver_name, job->func, job->input, job->input_length);
+
+    if (job->on_complete) job->on_complete(job);
+    atomic_store_u32(&job->state, RUN_JOB_DONE);
+    if (run_job_wakeup) run_job_wakeup();
+}
+
+bool
+run_job_submit(ThreadPool    *pool,
+               RunJob        *job,
+               const char    *solver_name,
+               ProblemFunc    func,
+               const char    *input,
+               usize          input_length,
+               u32            repeat_count,
+               RunJobCallback on_complete)
+{
+    if (run_job_state(job) == RUN_JOB_RUNNING) return false;
+
+    job->solver_name  = solver_name;
+    job->func         = func;
+    job->both_func    = NULL;
+    job->fused_job    = NULL;
+    job->input        = input;
+    job->input_length = input_length;
+    job->repeat_count = repeat_count;
+    job->on_complete  = on_complete;
+    job->context      = (SolverContext){.pool = pool};
+    atomic_store_u32(&job->state, RUN_JOB_RUNNING);
+
+    thread_pool_submit(pool, run_job_task, job);
+    return true;
+}
+
+bool
+run_job_submit_both(ThreadPool    *pool,
+                    RunJob        *part1_job,
+                    RunJob        *part2_job,
+                    const char    *part1_name,
+                    const char    *part2_name,
+                    SolveBothFunc  func,
+                    const char    *input,
+                    usize          input_length,
+                    u32            repeat_count,
+                    RunJobCallback on_complete)
+{
+    if (run_job_state(part1_job) == RUN_JOB_RUNNING || run_job_state(part2_job) == RUN_JOB_RUNNING) return false;
+
+    RunJob     *jobs[2]  = {part1_job, part2_job};
+    const char *names[2] = {part1_name, part2_name};
+    for (usize i = 0; i < 2; ++i) {
+        RunJob *job = jobs[i];
+        job->solver_name  = names[i];
+        job->func         = NULL;
+        job->both_func    = i == 0 ? func : NULL;
+        job->fused_job    = jobs[1 - i];
+        job->input        = input;
+        job->input_length = input_length;
+        job->repeat_count = repeat_count;
+        job->on_complete  = on_complete;
+        job->context      = (SolverContext){.pool = pool};
+        atomic_store_u32(&job->state, RUN_JOB_RUNNING);
+    }
+
+    thread_pool_submit(pool, run_job_task, part1_job);
+    return true;
+}
+
+RunJobState
+run_job_state(RunJob *job)
+{
+    return (RunJobState)atomic_load_u32(&job->state);
+}
+
+void
+run_job_cancel(RunJob *job)
+{
+    if (run_job_state(job) != RUN_JOB_RUNNING) return;
+    atomic_store_u32(&job->context.cancelled, 1);
+    if (job->fused_job) atomic_store_u32(&job->fused_job->context.cancelled, 1);
+}
+
+f32
+run_job_progress(RunJob *job)
+{
+    if (job->fused_job && !job->both_func) job = job->fused_job;
+    u64 total = atomic_load_u64(&job->context.progress_total);
+    if (total == 0) return -1.0f;
+    u64 progress = atomic_load_u64(&job->context.progress);
+    return progress >= total ? 1.0f : (f32)((f64)progress / (f64)total);
+}
+
+void
+run_job_set_wakeup(void (*wakeup)(void))
+{
+    run_job_wakeup = wakeup;
+}
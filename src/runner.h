@@ -0,0 +1,117 @@
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include "basic.h"
+#include "days.h"
+#include "alloc_track.h"
+
+typedef struct {
+    char *answer;
+    usize input_size;
+    u64   solve_ns;     // Duration of the most recent run
+    bool  cached;       // Answer came from the result cache, solve_ns is the lookup
+    bool  cancelled;    // Stopped before it finished, there is no answer
+    bool  both;         // Solved along with the other part by a SolveBothFunc, solve_ns covers both
+
+    u32   repeat_count; // Runs behind min_ns/median_ns, 0 if never repeated
+    u64   min_ns;
+    u64   median_ns;    // Mean of the two middle runs for an even repeat_count
+
+    char  summary[160]; // Human readable timing and throughput of the above
+
+    AllocStats allocations;             // Of the most recent run, only with AOC2025_ALLOC_TRACK
+    char       allocation_summary[256]; // Human readable allocations, empty if they were not tracked
+} RunResult;
+
+// Runs func once and records its answer and timing into result, replacing
+// whatever result held before. solver_name identifies func in the result
+// cache, which is consulted first when enabled. context is handed to func.
+void run_solver(RunResult *result, SolverContext *context, const char *solver_name, ProblemFunc func,
+                const char *input, usize input_length);
+
+// Like run_solver, but runs func repeat_count times and also records the
+// minimum and median duration. Never uses the result cache.
+void run_solver_repeated(RunResult *result, SolverContext *context, ProblemFunc func,
+                         const char *input, usize input_length, u32 repeat_count);
+
+// Like run_solver_repeated, but solves both parts with each call of func, into
+// part1 and part2. A single run consults the result cache under both names,
+// and only uses it when both answers are in there.
+void run_solver_both(RunResult *part1, RunResult *part2, SolverContext *context, const char *part1_name,
+                     const char *part2_name, SolveBothFunc func, const char *input, usize input_length,
+                     u32 repeat_count);
+
+void run_result_free(RunResult *result);
+
+// Persistent answer cache, one file per (solver name, solver build id,
+// input bytes) in directory. Disabled until a directory is set, pass NULL
+// to disable it again.
+void result_cache_set_directory(const char *directory);
+
+
+// Asynchronous runs on a thread pool. A job is written by its worker while
+// RUN_JOB_RUNNING, and its result may only be read by others once
+// run_job_state() reports RUN_JOB_DONE.
+typedef enum {
+    RUN_JOB_IDLE,
+    RUN_JOB_RUNNING,
+    RUN_JOB_DONE,
+} RunJobState;
+
+typedef struct RunJob RunJob;
+typedef void (*RunJobCallback)(RunJob *job);
+
+struct RunJob {
+    const char     *solver_name;
+    ProblemFunc     func;
+    SolveBothFunc   both_func;   // Set instead of func on the part 1 job of run_job_submit_both()
+    RunJob         *fused_job;   // The other part's job of run_job_submit_both(), NULL otherwise
+    const char     *input;
+    usize           input_length;
+    u32             repeat_count;
+    RunJobCallback  on_complete; // Called on the worker thread once result is ready, before the job is marked done
+    volatile u32    state;
+    SolverContext   context;     // Reset on submit
+    RunResult       result;
+};
+
+// Returns false, and does nothing, if the job is already running
+bool run_job_submit(ThreadPool    *pool,
+                    RunJob        *job,
+                    const char    *solver_name,
+                    ProblemFunc    func,
+                    const char    *input,
+                    usize          input_length,
+                    u32            repeat_count,
+                    RunJobCallback on_complete);
+
+// Runs func once for both parts, and completes both jobs with its answers.
+// The solver reports progress into the part 1 job, the part 2 job follows
+// it. Returns false, and does nothing, if either job is already running.
+bool run_job_submit_both(ThreadPool    *pool,
+                         RunJob        *part1_job,
+                         RunJob        *part2_job,
+                         const char    *part1_name,
+                         const char    *part2_name,
+                         SolveBothFunc  func,
+                         const char    *input,
+                         usize          input_length,
+                         u32            repeat_count,
+                         RunJobCallback on_complete);
+
+RunJobState run_job_state(RunJob *job);
+
+// Asks a running job to stop. It still completes as usual, with a cancelled
+// result unless the solver finished first. Does nothing to jobs not running.
+// Stops both jobs of run_job_submit_both().
+void run_job_cancel(RunJob *job);
+
+// Share of the work done by a running job, from 0 to 1, or negative while
+// its solver has not reported any progress
+f32 run_job_progress(RunJob *job);
+
+// Called on the worker thread after any job is marked done, e.g. to wake up a
+// UI thread that sleeps until something changes
+void run_job_set_wakeup(void (*wakeup)(void));
+
+#endif
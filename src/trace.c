@@ -0,0 +1,127 @@
+#include "trace.h"
+
+#ifdef AOC2025_TRACE
+
+#include <stdio.h>
+
+// A ring, once it is full the newest events overwrite the oldest. Thread
+// names are kept apart, so they are not lost when it wraps.
+#define TRACE_MAX_EVENTS       (1u << 18)
+#define TRACE_MAX_THREAD_NAMES 256
+
+typedef struct {
+    const char *name;
+    u64         timestamp_ns;
+    u32         thread_id;
+    char        phase;
+} TraceEvent;
+
+static TraceEvent   trace_events[TRACE_MAX_EVENTS];
+static volatile u64 trace_event_count = 0;
+static TraceEvent   trace_thread_names[TRACE_MAX_THREAD_NAMES];
+static volatile u32 trace_thread_name_count = 0;
+
+static void
+trace_fill(TraceEvent *event, const char *name, char phase)
+{
+    event->name         = name;
+    event->timestamp_ns = time_now_ns();
+    event->thread_id    = current_thread_id();
+    event->phase        = phase;
+}
+
+static void
+trace_record(const char *name, char phase)
+{
+    u64 index = atomic_fetch_add_u64(&trace_event_count, 1);
+    trace_fill(&trace_events[index % TRACE_MAX_EVENTS], name, phase);
+}
+
+void
+trace_begin(const char *name)
+{
+    trace_record(name, 'B');
+}
+
+void
+trace_end(const char *name)
+{
+    trace_record(name, 'E');
+}
+
+void
+trace_set_thread_name(const char *name)
+{
+    u32 index = atomic_fetch_add_u32(&trace_thread_name_count, 1);
+    if (index >= TRACE_MAX_THREAD_NAMES) return; // Full, the thread keeps its id as its name
+    trace_fill(&trace_thread_names[index], name, 'M');
+}
+
+bool
+trace_write(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "Could not open trace file \"%s\"\n", path);
+        return false;
+    }
+
+    u64 count = trace_event_count;
+    u64 first = 0;
+    if (count > TRACE_MAX_EVENTS) {
+        printf("Trace buffer wrapped, kept the newest %u of %llu events\n", TRACE_MAX_EVENTS, (unsigned long long)count);
+        first = count - TRACE_MAX_EVENTS;
+    }
+
+    u32 thread_name_count = trace_thread_name_count;
+    if (thread_name_count > TRACE_MAX_THREAD_NAMES) thread_name_count = TRACE_MAX_THREAD_NAMES;
+
+    u64 first_timestamp_ns = UINT64_MAX;
+    u32 max_thread_id      = 0;
+    for (u64 i = first; i < count; ++i) {
+        TraceEvent *event = &trace_events[i % TRACE_MAX_EVENTS];
+        if (event->timestamp_ns < first_timestamp_ns) first_timestamp_ns = event->timestamp_ns;
+        if (event->thread_id > max_thread_id) max_thread_id = event->thread_id;
+    }
+
+    // Where the ring wrapped, a thread's oldest events can be ends whose begin
+    // was overwritten. Those are left out by counting each thread's open begins.
+    u32 *open_counts = calloc(max_thread_id + 1, sizeof(*open_counts));
+    if (!open_counts) {
+        fprintf(stderr, "Could not allocate the trace writer's thread table\n");
+        fclose(f);
+        return false;
+    }
+
+    const char *separator = "";
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (u32 i = 0; i < thread_name_count; ++i) {
+        TraceEvent *event = &trace_thread_names[i];
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}\n",
+                separator, event->thread_id, event->name);
+        separator = ",";
+    }
+    u64 written_count = 0;
+    for (u64 i = first; i < count; ++i) {
+        TraceEvent *event = &trace_events[i % TRACE_MAX_EVENTS];
+        if (event->phase == 'B') {
+            open_counts[event->thread_id] += 1;
+        } else {
+            if (open_counts[event->thread_id] == 0) continue;
+            open_counts[event->thread_id] -= 1;
+        }
+        f64 timestamp_us = (f64)(event->timestamp_ns - first_timestamp_ns) / 1000.0;
+        fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}\n",
+                separator, event->name, event->phase, timestamp_us, event->thread_id);
+        separator = ",";
+        written_count += 1;
+    }
+    free(open_counts);
+    fprintf(f, "]}\n");
+    fclose(f);
+
+    printf("Wrote %llu trace events to \"%s\"\n", (unsigned long long)written_count, path);
+    return true;
+}
+
+#endif
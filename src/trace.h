@@ -0,0 +1,32 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "basic.h"
+
+// Chrome trace event recorder. Begin/end pairs are stored in a fixed ring
+// shared by all threads that keeps the newest events, and written as JSON
+// that Perfetto and chrome://tracing can open. Compiled out unless AOC2025_TRACE is defined
+// (`bs --trace`). Event names are not copied, so pass string literals.
+
+#ifdef AOC2025_TRACE
+
+void trace_begin(const char *name);
+void trace_end(const char *name);
+void trace_set_thread_name(const char *name);
+bool trace_write(const char *path);
+
+#define TRACE_BEGIN(name)           trace_begin(name)
+#define TRACE_END(name)             trace_end(name)
+#define TRACE_SET_THREAD_NAME(name) trace_set_thread_name(name)
+#define TRACE_WRITE(path)           trace_write(path)
+
+#else
+
+#define TRACE_BEGIN(name)
+#define TRACE_END(name)
+#define TRACE_SET_THREAD_NAME(name)
+#define TRACE_WRITE(path)
+
+#endif
+
+#endif
@@ -7,6 +7,8 @@
 
 extern void *GetWindowHandle(void);
 
+const char *solver_library_path = "build/bin/aoc2025_solvers.dll";
+
 void
 set_native_window_icon(void)
 {
@@ -30,6 +32,26 @@ set_native_window_icon(void)
     SendMessage(native_window, WM_SETICON, ICON_SMALL, (LPARAM)small_icon);
 }
 
+void *
+library_load(const char *path)
+{
+    HMODULE library = LoadLibraryA(path);
+    if (!library) fprintf(stderr, "Could not load \"%s\" (error %lu)\n", path, GetLastError());
+    return (void *)library;
+}
+
+void *
+library_symbol(void *library, const char *name)
+{
+    return (void *)GetProcAddress((HMODULE)library, name);
+}
+
+void
+library_unload(void *library)
+{
+    FreeLibrary((HMODULE)library);
+}
+
 int APIENTRY
 WinMain(HINSTANCE hInstance,
         HINSTANCE hPrevInstance,
@@ -45,7 +67,7 @@ WinMain(HINSTANCE hInstance,
 #endif
 
 
-    int exit_code = aoc2025_entry();
+    int exit_code = aoc2025_entry(__argc, __argv);
 
     return exit_code;
 }
@@ -0,0 +1,234 @@
+// Rasterizes fonts into atlases and writes them out as C source, so the app
+// can upload them without loading or rasterizing anything at startup. bs
+// builds and runs this, it can not do it itself because it is bootstrapped
+// without the math library stb_truetype needs.
+//
+//     bake_fonts <output.c> <font.ttf> <size> [<font.ttf> <size>]...
+//
+// The glyphs and the atlas match what LoadFontEx(path, size, NULL, 400)
+// produces: FONT_DEFAULT rasterization, the basic packing method, and the
+// white rectangle in the bottom right corner.
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#define STBTT_STATIC
+#include "stb_truetype.h"
+
+#define GLYPH_COUNT     400
+#define FIRST_CODEPOINT 32
+#define GLYPH_PADDING   4 // FONT_TTF_DEFAULT_CHARS_PADDING
+
+typedef struct {
+    char *items;
+    size_t count;
+    size_t capacity;
+} Buffer;
+
+static void
+append(Buffer *buffer, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int length = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+
+    if (buffer->count + length + 1 > buffer->capacity) {
+        while (buffer->count + length + 1 > buffer->capacity) {
+            buffer->capacity = buffer->capacity ? buffer->capacity*2 : 4096;
+        }
+        buffer->items = (char *)realloc(buffer->items, buffer->capacity);
+    }
+
+    va_start(args, fmt);
+    vsnprintf(buffer->items + buffer->count, length + 1, fmt, args);
+    va_end(args);
+    buffer->count += length;
+}
+
+static unsigned char *
+read_file(const char *path, size_t *size)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char *data = (unsigned char *)malloc(length > 0 ? length : 1);
+    *size = fread(data, 1, length, file);
+    fclose(file);
+    return data;
+}
+
+typedef struct {
+    int            value;
+    int            offset_x, offset_y;
+    int            advance_x;
+    int            width, height;
+    unsigned char *bitmap;
+    int            x, y;
+} Glyph;
+
+static bool
+bake_font(Buffer *out, Buffer *table, int font_index, const char *path, int size)
+{
+    size_t         ttf_size = 0;
+    unsigned char *ttf      = read_file(path, &ttf_size);
+    if (!ttf) {
+        fprintf(stderr, "bake_fonts: could not read \"%s\"\n", path);
+        return false;
+    }
+
+    stbtt_fontinfo info = {0};
+    if (!stbtt_InitFont(&info, ttf, 0)) {
+        fprintf(stderr, "bake_fonts: \"%s\" is not a font\n", path);
+        free(ttf);
+        return false;
+    }
+
+    float scale = stbtt_ScaleForPixelHeight(&info, (float)size);
+    int ascent, descent, line_gap;
+    stbtt_GetFontVMetrics(&info, &ascent, &descent, &line_gap);
+
+    // Rasterize, as LoadFontData does for FONT_DEFAULT
+    static Glyph glyphs[GLYPH_COUNT];
+    memset(glyphs, 0, sizeof(glyphs));
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        Glyph *glyph = &glyphs[i];
+        int    codepoint = FIRST_CODEPOINT + i;
+        glyph->value = codepoint;
+        if (stbtt_FindGlyphIndex(&info, codepoint) <= 0) continue;
+
+        glyph->bitmap = stbtt_GetCodepointBitmap(&info, scale, scale, codepoint, &glyph->width, &glyph->height,
+                                                 &glyph->offset_x, &glyph->offset_y);
+        if (glyph->bitmap) {
+            stbtt_GetCodepointHMetrics(&info, codepoint, &glyph->advance_x, NULL);
+            glyph->advance_x  = (int)((float)glyph->advance_x*scale);
+            glyph->offset_y  += (int)((float)ascent*scale);
+        }
+        if (codepoint == ' ') {
+            stbtt_GetCodepointHMetrics(&info, codepoint, &glyph->advance_x, NULL);
+            glyph->advance_x = (int)((float)glyph->advance_x*scale);
+            free(glyph->bitmap);
+            glyph->width  = glyph->advance_x;
+            glyph->height = size;
+            glyph->bitmap = (unsigned char *)calloc(glyph->width*glyph->height + 1, 1);
+        }
+    }
+
+    // Size the atlas, as GenImageFontAtlas does, but without libm
+    int total_width = 0;
+    for (int i = 0; i < GLYPH_COUNT; ++i) total_width += glyphs[i].width + 2*GLYPH_PADDING;
+    float total_area = (float)total_width*(float)(size + 2*GLYPH_PADDING)*1.2f;
+    int   image_size = 1;
+    while ((float)image_size*(float)image_size < total_area) image_size *= 2;
+    int atlas_width  = image_size;
+    int atlas_height = total_area < (float)(image_size*image_size)/2 ? image_size/2 : image_size;
+
+    unsigned char *atlas = (unsigned char *)calloc((size_t)atlas_width*atlas_height, 1);
+
+    // Basic packing, one glyph after another
+    int x = GLYPH_PADDING;
+    int y = GLYPH_PADDING;
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        Glyph *glyph = &glyphs[i];
+        if (x >= atlas_width - glyph->width - 2*GLYPH_PADDING) {
+            x  = GLYPH_PADDING;
+            y += size + 2*GLYPH_PADDING;
+            if (y > atlas_height - size - GLYPH_PADDING) {
+                fprintf(stderr, "bake_fonts: \"%s\" at %d does not fit its atlas\n", path, size);
+                return false;
+            }
+        }
+        for (int row = 0; row < glyph->height; ++row) {
+            memcpy(atlas + (size_t)(y + row)*atlas_width + x, glyph->bitmap + row*glyph->width, glyph->width);
+        }
+        glyph->x = x;
+        glyph->y = y;
+        x += glyph->width + 2*GLYPH_PADDING;
+    }
+
+    // White rectangle for drawing shapes with the font texture
+    for (int row = 0; row < 3; ++row) {
+        memset(atlas + (size_t)(atlas_height - 1 - row)*atlas_width + atlas_width - 3, 255, 3);
+    }
+
+    append(out, "\n// %s at %d\n", path, size);
+    append(out, "static const EmbeddedGlyph font%d_glyphs[%d] = {\n", font_index, GLYPH_COUNT);
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        Glyph *glyph = &glyphs[i];
+        append(out, "    {%d, %d, %d, %d, %d, %d, %d, %d},\n", glyph->value, glyph->offset_x, glyph->offset_y,
+               glyph->advance_x, glyph->x, glyph->y, glyph->width, glyph->height);
+    }
+    append(out, "};\n");
+
+    append(out, "EMBEDDED_ALIGNED static const unsigned char font%d_atlas[%d] = {", font_index, atlas_width*atlas_height);
+    for (int i = 0; i < atlas_width*atlas_height; ++i) {
+        append(out, i % 32 == 0 ? "\n    %d," : "%d,", atlas[i]);
+    }
+    append(out, "\n};\n");
+
+    append(table, "    {\"%s\", %d, %d, %d, font%d_glyphs, %d, %d, font%d_atlas},\n",
+           path, size, GLYPH_PADDING, GLYPH_COUNT, font_index, atlas_width, atlas_height, font_index);
+
+    for (int i = 0; i < GLYPH_COUNT; ++i) free(glyphs[i].bitmap);
+    free(atlas);
+    free(ttf);
+    return true;
+}
+
+int
+main(int argc, char **argv)
+{
+    if (argc < 2 || argc % 2 != 0) {
+        fprintf(stderr, "usage: %s <output.c> <font.ttf> <size> [<font.ttf> <size>]...\n", argv[0]);
+        return 1;
+    }
+    const char *output_path = argv[1];
+    int         font_count  = (argc - 2) / 2;
+
+    Buffer out   = {0};
+    Buffer table = {0};
+    append(&out, "// Generated by tools/bake_fonts.c, do not edit\n");
+    append(&out, "#include \"embedded.h\"\n\n");
+    append(&out, "#include <string.h>\n");
+
+    for (int i = 0; i < font_count; ++i) {
+        const char *path = argv[2 + 2*i];
+        int         size = atoi(argv[3 + 2*i]);
+        if (!bake_font(&out, &table, i, path, size)) return 1;
+    }
+
+    append(&out, "\nstatic const EmbeddedFont embedded_fonts[] = {\n%.*s    {0}\n};\n", (int)table.count, table.items ? table.items : "");
+    append(&out,
+           "\n"
+           "const EmbeddedFont *\n"
+           "embedded_font(const char *path, int size)\n"
+           "{\n"
+           "    for (const EmbeddedFont *font = embedded_fonts; font->path; ++font) {\n"
+           "        if (font->size == size && strcmp(font->path, path) == 0) return font;\n"
+           "    }\n"
+           "    return NULL;\n"
+           "}\n");
+
+    // Leave the output alone when nothing changed, it is slow to compile
+    size_t         old_size = 0;
+    unsigned char *old      = read_file(output_path, &old_size);
+    bool           changed  = !old || old_size != out.count || memcmp(old, out.items, out.count) != 0;
+    free(old);
+    if (changed) {
+        FILE *file = fopen(output_path, "wb");
+        if (!file || fwrite(out.items, 1, out.count, file) != out.count) {
+            fprintf(stderr, "bake_fonts: could not write \"%s\"\n", output_path);
+            return 1;
+        }
+        fclose(file);
+    }
+    free(out.items);
+    free(table.items);
+    return 0;
+}